@@ -0,0 +1,232 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ASYNC_CPP
+#define ASYNC_CPP
+
+#ifndef ASYNC_HPP
+#include "async.hpp"
+#endif
+
+template<typename type>
+async_result<type>::async_result(void)
+: m_state(std::make_shared<state>()) {}
+
+template<typename type>
+bool async_result<type>::is_ready(void) const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+
+	return m_state->value.has_value();
+}
+
+template<typename type>
+bool async_result<type>::is_valid(void) const
+{
+	return m_state != nullptr;
+}
+
+template<typename type>
+bool async_result<type>::set_value(type value) const
+{
+	std::vector<std::function<void (void)>> next;
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		if (m_state->value) return false;
+
+		m_state->value.emplace(std::move(value));
+		next.swap(m_state->next);
+	}
+
+	m_state->cond.notify_all();
+
+	for (auto& f : next) f();
+
+	return true;
+}
+
+template<typename type>
+bool async_result<type>::on_ready(std::function<void (void)> fun) const
+{
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		if (!m_state->value)
+		{
+			m_state->next.push_back(std::move(fun));
+
+			return false;
+		}
+	}
+
+	fun();
+
+	return true;
+}
+
+template<typename type>
+void async_result<type>::wait(void) const
+{
+	auto& pool = thread_pool::global();
+
+	while (!is_ready())
+	{
+		if (pool.run_one()) continue;
+
+		std::unique_lock<std::mutex> lock(m_state->mutex);
+
+		m_state->cond.wait_for(lock, std::chrono::microseconds(200), [this] (void)
+		{
+			return m_state->value.has_value();
+		});
+	}
+}
+
+template<typename type>
+const type& async_result<type>::get(void) const
+{
+	wait();
+
+	return *m_state->value;
+}
+
+template<typename type> template<typename fun>
+auto async_result<type>::then(fun&& f) const -> async_result<std::invoke_result_t<fun, const type&>>
+{
+	return when_all(std::forward<fun>(f), *this);
+}
+
+inline void async_post(std::function<void (void)> task)
+{
+	thread_pool::global().submit([task = std::move(task)] (void)
+	{
+		const bool nest = parallel::get_backend() == parallel::backend::pool;
+		policy_scope scope(nest ? exec_policy::automatic : exec_policy::seq);
+
+		task();
+	});
+}
+
+template<typename fun>
+auto async_run(fun&& f) -> async_result<std::invoke_result_t<fun>>
+{
+	async_result<std::invoke_result_t<fun>> out;
+
+	async_post([out, f = std::forward<fun>(f)] (void) mutable
+	{
+		out.set_value(f());
+	});
+
+	return out;
+}
+
+template<typename fun, typename... types>
+auto when_all(fun&& f, const async_result<types>&... args)
+	-> async_result<std::invoke_result_t<fun, const types&...>>
+{
+	using result = std::invoke_result_t<fun, const types&...>;
+
+	async_result<result> out;
+
+	auto left = std::make_shared<std::atomic<size_t>>(sizeof...(types) + 1);
+	auto call = std::make_shared<std::function<void (void)>>(
+		[out, left, f = std::forward<fun>(f), args...] (void) mutable
+		{
+			if (left->fetch_sub(1) != 1) return;
+
+			async_post([out, f = std::move(f), args...] (void) mutable
+			{
+				out.set_value(f(args.get()...));
+			});
+		});
+
+	(args.on_ready([call] (void) { (*call)(); }), ...);
+
+	(*call)();
+
+	return out;
+}
+
+template<typename data>
+async_result<matrix<data>> async_mul(const matrix<data>& a, const matrix<data>& b)
+{
+	return async_run([&a, &b] (void) { return matrix<data>(a * b); });
+}
+
+template<typename data>
+async_result<matrix<data>> async_mul(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b)
+{
+	return when_all([] (const matrix<data>& x, const matrix<data>& y)
+	{
+		return matrix<data>(x * y);
+	}, a, b);
+}
+
+template<typename data>
+async_result<matrix<data>> async_add(const matrix<data>& a, const matrix<data>& b)
+{
+	return async_run([&a, &b] (void) { return matrix<data>(a + b); });
+}
+
+template<typename data>
+async_result<matrix<data>> async_add(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b)
+{
+	return when_all([] (const matrix<data>& x, const matrix<data>& y)
+	{
+		return matrix<data>(x + y);
+	}, a, b);
+}
+
+template<typename data>
+async_result<matrix<data>> async_sub(const matrix<data>& a, const matrix<data>& b)
+{
+	return async_run([&a, &b] (void) { return matrix<data>(a - b); });
+}
+
+template<typename data>
+async_result<matrix<data>> async_sub(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b)
+{
+	return when_all([] (const matrix<data>& x, const matrix<data>& y)
+	{
+		return matrix<data>(x - y);
+	}, a, b);
+}
+
+template<typename data, typename fun>
+async_result<matrix<data>> async_apply(const matrix<data>& a, const fun& f)
+{
+	return async_run([&a, f] (void) { return a.apply(f, exec_policy::current()); });
+}
+
+template<typename data, typename fun>
+async_result<matrix<data>> async_apply(const async_result<matrix<data>>& a, const fun& f)
+{
+	return a.then([f] (const matrix<data>& x)
+	{
+		return x.apply(f, exec_policy::current());
+	});
+}
+
+#endif
@@ -0,0 +1,113 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include <condition_variable>
+#include <type_traits>
+#include <functional>
+#include <optional>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <tuple>
+#include <mutex>
+
+#include "matrix.hpp"
+
+template<typename type>
+class async_result
+{
+
+	protected:
+
+		struct state
+		{
+			std::mutex mutex;
+			std::condition_variable cond;
+
+			std::optional<type> value;
+			std::vector<std::function<void (void)>> next;
+		};
+
+		std::shared_ptr<state> m_state;
+
+		template<typename other> friend class async_result;
+
+	public:
+
+		async_result(void);
+
+		bool is_ready(void) const;
+		bool is_valid(void) const;
+
+		bool set_value(type value) const;
+		bool on_ready(std::function<void (void)> fun) const;
+
+		const type& get(void) const;
+		void wait(void) const;
+
+		template<typename fun>
+		auto then(fun&& f) const -> async_result<std::invoke_result_t<fun, const type&>>;
+
+};
+
+void async_post(std::function<void (void)> task);
+
+template<typename fun>
+auto async_run(fun&& f) -> async_result<std::invoke_result_t<fun>>;
+
+template<typename fun, typename... types>
+auto when_all(fun&& f, const async_result<types>&... args)
+	-> async_result<std::invoke_result_t<fun, const types&...>>;
+
+template<typename data>
+async_result<matrix<data>> async_mul(const matrix<data>& a, const matrix<data>& b);
+
+template<typename data>
+async_result<matrix<data>> async_mul(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b);
+
+template<typename data>
+async_result<matrix<data>> async_add(const matrix<data>& a, const matrix<data>& b);
+
+template<typename data>
+async_result<matrix<data>> async_add(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b);
+
+template<typename data>
+async_result<matrix<data>> async_sub(const matrix<data>& a, const matrix<data>& b);
+
+template<typename data>
+async_result<matrix<data>> async_sub(const async_result<matrix<data>>& a,
+							  const async_result<matrix<data>>& b);
+
+template<typename data, typename fun>
+async_result<matrix<data>> async_apply(const matrix<data>& a, const fun& f);
+
+template<typename data, typename fun>
+async_result<matrix<data>> async_apply(const async_result<matrix<data>>& a, const fun& f);
+
+#ifndef ASYNC_CPP
+#include "async.cpp"
+#endif
+
+#endif // ASYNC_HPP
@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "async.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const matrix<int> a(4, 2, { 1, 2, 3, 4, 5, 6, 7, 8 });
+	const matrix<int> b(2, 3, { 1, 2, 3, 4, 5, 6 });
+	const matrix<int> g(3, 3, { 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+	const matrix<int> r1(4, 3, { 9, 12, 15, 19, 26, 33, 29, 40, 51, 39, 54, 69 });
+	const matrix<int> r3(4, 3, { 162, 198, 234, 354, 432, 510, 546, 666, 786, 738, 900, 1062 });
+
+	const auto fun = [] (int v) { return v * 2; };
+
+	const auto c = async_mul(a, b);
+	const auto h = async_mul(c, async_run([&g] (void) { return g; }));
+	const auto s = async_add(c, c);
+	const auto d = async_apply(c, fun);
+	const auto z = async_sub(s, d);
+
+	const auto t = when_all([] (const matrix<int>& x, const matrix<int>& y)
+	{
+		return x.rows() + y.cols();
+	}, c, h);
+
+	if (c.get() != r1) endtest(n, ok);
+	if (h.get() != r3) endtest(n, ok);
+	if (s.get() != r1 * 2 || d.get() != r1 * 2) endtest(n, ok);
+	if (z.get() != matrix<int>(4, 3, 0)) endtest(n, ok);
+	if (t.get() != 7 || !t.is_ready()) endtest(n, ok);
+
+	return !(n == ok);
+}
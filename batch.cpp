@@ -0,0 +1,399 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BATCH_CPP
+#define BATCH_CPP
+
+#ifndef BATCH_HPP
+#include "batch.hpp"
+#endif
+
+template<typename data>
+matrix_batch<data>::matrix_batch(size_t count, size_t rows, size_t cols)
+{
+	resize(count, rows, cols);
+}
+
+template<typename data>
+matrix_batch<data>::matrix_batch(size_t count, size_t rows, size_t cols, const data& val)
+{
+	if (resize(count, rows, cols)) std::fill(m_ptr, m_ptr + count * rows * cols, val);
+}
+
+template<typename data>
+matrix_batch<data>::matrix_batch(const std::vector<matrix<data>>& list)
+{
+	if (list.empty() || !resize(list.size(), list[0].rows(), list[0].cols())) return;
+
+	for (size_t i = 0; i < list.size(); ++i) set(i, list[i]);
+}
+
+template<typename data>
+matrix_batch<data>::matrix_batch(const matrix_batch<data>& other)
+{
+	*this = other;
+}
+
+template<typename data>
+matrix_batch<data>::matrix_batch(matrix_batch<data>&& other)
+{
+	*this = std::move(other);
+}
+
+template<typename data>
+size_t matrix_batch<data>::get_threads(size_t work)
+{
+	switch (exec_policy::current().get_kind())
+	{
+	case exec_policy::kind::seq: return 1;
+	case exec_policy::kind::automatic: break;
+	default: return parallel::threads();
+	}
+
+	return cost_model::global().threads(cost_model::op::gemm, work, sizeof(data));
+}
+
+template<typename data> template<size_t M, size_t K, size_t N>
+void matrix_batch<data>::kernel(const data* a, const data* b, data* c)
+{
+	for (size_t i = 0; i < M; ++i)
+	{
+		data row[N] = {};
+
+		for (size_t k = 0; k < K; ++k)
+		{
+			const data mul = a[i * K + k];
+			const data* src = b + k * N;
+
+			for (size_t j = 0; j < N; ++j) row[j] += mul * src[j];
+		}
+
+		std::copy(row, row + N, c + i * N);
+	}
+}
+
+template<typename data>
+void matrix_batch<data>::kernel(const data* a, const data* b, data* c,
+						  size_t m, size_t k, size_t n)
+{
+	std::fill(c, c + m * n, data(0));
+
+	for (size_t i = 0; i < m; ++i)
+	{
+		data* dst = c + i * n;
+
+		for (size_t l = 0; l < k; ++l)
+		{
+			const data mul = a[i * k + l];
+			const data* src = b + l * n;
+
+			for (size_t j = 0; j < n; ++j) dst[j] += mul * src[j];
+		}
+	}
+}
+
+template<typename data>
+void matrix_batch<data>::dispatch(const data* a, const data* b, data* c,
+						    size_t m, size_t k, size_t n)
+{
+	if (m == k && k == n) switch (m)
+	{
+		case 2: return kernel<2, 2, 2>(a, b, c);
+		case 3: return kernel<3, 3, 3>(a, b, c);
+		case 4: return kernel<4, 4, 4>(a, b, c);
+		case 8: return kernel<8, 8, 8>(a, b, c);
+		case 16: return kernel<16, 16, 16>(a, b, c);
+		case 32: return kernel<32, 32, 32>(a, b, c);
+		case 64: return kernel<64, 64, 64>(a, b, c);
+	}
+
+	kernel(a, b, c, m, k, n);
+}
+
+template<typename data> template<typename fun>
+void matrix_batch<data>::interleaved(const fun& get, size_t first, size_t m, size_t k, size_t n,
+							  std::vector<data>& buff)
+{
+	const size_t sa = m * k, sb = k * n, sc = m * n;
+
+	buff.resize(s_lanes * (sa + sb + sc));
+
+	data* pa = buff.data();
+	data* pb = pa + s_lanes * sa;
+	data* pc = pb + s_lanes * sb;
+
+	for (size_t l = 0; l < s_lanes; ++l)
+	{
+		const auto [a, b, c] = get(first + l);
+
+		for (size_t i = 0; i < sa; ++i) pa[i * s_lanes + l] = a[i];
+		for (size_t i = 0; i < sb; ++i) pb[i * s_lanes + l] = b[i];
+	}
+
+	std::fill(pc, pc + s_lanes * sc, data(0));
+
+	for (size_t i = 0; i < m; ++i)
+		for (size_t l = 0; l < k; ++l)
+		{
+			const data* x = pa + (i * k + l) * s_lanes;
+
+			for (size_t j = 0; j < n; ++j)
+			{
+				const data* y = pb + (l * n + j) * s_lanes;
+				data* z = pc + (i * n + j) * s_lanes;
+
+				for (size_t v = 0; v < s_lanes; ++v) z[v] += x[v] * y[v];
+			}
+		}
+
+	for (size_t l = 0; l < s_lanes; ++l)
+	{
+		data* c = std::get<2>(get(first + l));
+
+		for (size_t i = 0; i < sc; ++i) c[i] = pc[i * s_lanes + l];
+	}
+}
+
+template<typename data> template<typename fun>
+void matrix_batch<data>::run(size_t count, size_t m, size_t k, size_t n,
+					    bool interleave, const fun& get)
+{
+	MATRIX_PROFILE_SCOPE("batch_gemm", count * m * n);
+
+	const size_t groups = interleave ? count / s_lanes : 0;
+	const size_t tnum = get_threads(count * m * k * n);
+
+	parallel::run(groups, tnum, [&] (size_t b, size_t e)
+	{
+		std::vector<data> buff;
+
+		for (size_t g = b; g < e; ++g) interleaved(get, g * s_lanes, m, k, n, buff);
+	});
+
+	parallel::run(count - groups * s_lanes, tnum, [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+		{
+			const auto [pa, pb, pc] = get(groups * s_lanes + i);
+
+			dispatch(pa, pb, pc, m, k, n);
+		}
+	});
+}
+
+template<typename data>
+size_t matrix_batch<data>::count(void) const
+{
+	return m_count;
+}
+
+template<typename data>
+size_t matrix_batch<data>::rows(void) const
+{
+	return m_rows;
+}
+
+template<typename data>
+size_t matrix_batch<data>::cols(void) const
+{
+	return m_cols;
+}
+
+template<typename data>
+size_t matrix_batch<data>::stride(void) const
+{
+	return m_rows * m_cols;
+}
+
+template<typename data>
+bool matrix_batch<data>::resize(size_t count, size_t rows, size_t cols)
+{
+	if (count == m_count && rows == m_rows && cols == m_cols) return false;
+	else if (count > 0 && rows > 0 && cols > 0) clear();
+	else return false;
+
+	const size_t bytes = count * rows * cols * sizeof(data);
+
+	auto& res = matrix_resource::current();
+	void* ptr = res.allocate(bytes, alignof(data));
+
+	if (ptr)
+	{
+		alloc_tracker::allocated(bytes);
+
+		m_ptr = static_cast<data*>(ptr);
+		m_res = &res;
+		m_count = count;
+		m_rows = rows;
+		m_cols = cols;
+	}
+
+	return m_ptr != nullptr;
+}
+
+template<typename data>
+bool matrix_batch<data>::clear(void)
+{
+	if (m_ptr == nullptr) return false;
+
+	const size_t bytes = m_count * m_rows * m_cols * sizeof(data);
+
+	m_res->deallocate(m_ptr, bytes, alignof(data));
+	alloc_tracker::released(bytes);
+
+	m_ptr = nullptr;
+	m_res = nullptr;
+	m_count = m_rows = m_cols = 0;
+
+	return true;
+}
+
+template<typename data>
+bool matrix_batch<data>::is_valid(void) const
+{
+	return m_ptr != nullptr;
+}
+
+template<typename data>
+data* matrix_batch<data>::ptr(size_t n)
+{
+	return m_ptr + n * m_rows * m_cols;
+}
+
+template<typename data>
+const data* matrix_batch<data>::ptr(size_t n) const
+{
+	return m_ptr + n * m_rows * m_cols;
+}
+
+template<typename data>
+matrix<data> matrix_batch<data>::get(size_t n) const
+{
+	if (n >= m_count) return matrix<data>();
+	else return matrix<data>(m_rows, m_cols, ptr(n));
+}
+
+template<typename data>
+bool matrix_batch<data>::set(size_t n, const matrix<data>& mat)
+{
+	if (n >= m_count || mat.rows() != m_rows || mat.cols() != m_cols) return false;
+
+	for (size_t i = 0; i < m_rows; ++i)
+		for (size_t j = 0; j < m_cols; ++j)
+			ptr(n)[i * m_cols + j] = mat(i, j);
+
+	return true;
+}
+
+template<typename data>
+data& matrix_batch<data>::operator() (size_t n, size_t row, size_t col)
+{
+	return m_ptr[(n * m_rows + row) * m_cols + col];
+}
+
+template<typename data>
+const data& matrix_batch<data>::operator() (size_t n, size_t row, size_t col) const
+{
+	return m_ptr[(n * m_rows + row) * m_cols + col];
+}
+
+template<typename data>
+matrix_batch<data>& matrix_batch<data>::operator= (const matrix_batch<data>& other)
+{
+	if (&other == this) return *this;
+	else resize(other.m_count, other.m_rows, other.m_cols);
+
+	std::copy(other.m_ptr, other.m_ptr + m_count * m_rows * m_cols, m_ptr);
+
+	return *this;
+}
+
+template<typename data>
+matrix_batch<data>& matrix_batch<data>::operator= (matrix_batch<data>&& other)
+{
+	if (&other != this) clear();
+	else return *this;
+
+	std::swap(m_ptr, other.m_ptr);
+	std::swap(m_res, other.m_res);
+	std::swap(m_count, other.m_count);
+	std::swap(m_rows, other.m_rows);
+	std::swap(m_cols, other.m_cols);
+
+	return *this;
+}
+
+template<typename data>
+matrix_batch<data>::~matrix_batch(void)
+{
+	clear();
+}
+
+template<typename data>
+bool matrix_batch<data>::gemm(const matrix_batch<data>& a, const matrix_batch<data>& b, matrix_batch<data>& c,
+						bool interleave, const exec_policy& pol)
+{
+	if (a.m_count != b.m_count || a.m_cols != b.m_rows || !a.is_valid()) return false;
+	else c.resize(a.m_count, a.m_rows, b.m_cols);
+
+	if (!c.is_valid() || &c == &a || &c == &b) return false;
+
+	policy_scope scope(pol);
+
+	run(a.m_count, a.m_rows, a.m_cols, b.m_cols, interleave, [&] (size_t i)
+	{
+		return std::make_tuple(a.ptr(i), b.ptr(i), c.ptr(i));
+	});
+
+	return true;
+}
+
+template<typename data>
+bool matrix_batch<data>::gemm(const std::vector<matrix<data>>& a, const std::vector<matrix<data>>& b,
+						std::vector<matrix<data>>& c, bool interleave, const exec_policy& pol)
+{
+	if (a.empty() || a.size() != b.size()) return false;
+
+	const size_t m = a[0].rows(), k = a[0].cols(), n = b[0].cols();
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].rows() != m || a[i].cols() != k) return false;
+		if (b[i].rows() != k || b[i].cols() != n) return false;
+	}
+
+	c.resize(a.size());
+
+	for (auto& mat : c)
+	{
+		if (!mat.resize(m, n)) mat.detach();
+	}
+
+	policy_scope scope(pol);
+
+	run(a.size(), m, k, n, interleave, [&] (size_t i)
+	{
+		return std::make_tuple(a[i].m_ptr, b[i].m_ptr, c[i].m_ptr);
+	});
+
+	return true;
+}
+
+#endif
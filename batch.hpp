@@ -0,0 +1,116 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <tuple>
+
+#include <cstddef>
+
+#include "matrix.hpp"
+
+template<typename data = double>
+class matrix_batch
+{
+
+	protected:
+
+		static constexpr size_t s_lanes = 8;
+
+		data* m_ptr = nullptr;
+		matrix_resource* m_res = nullptr;
+
+		size_t m_count = 0;
+		size_t m_rows = 0;
+		size_t m_cols = 0;
+
+		static size_t get_threads(size_t work);
+
+		template<size_t M, size_t K, size_t N>
+		static void kernel(const data* a, const data* b, data* c);
+
+		static void kernel(const data* a, const data* b, data* c,
+					    size_t m, size_t k, size_t n);
+
+		static void dispatch(const data* a, const data* b, data* c,
+						 size_t m, size_t k, size_t n);
+
+		template<typename fun>
+		static void interleaved(const fun& get, size_t first, size_t m, size_t k, size_t n,
+						    std::vector<data>& buff);
+
+		template<typename fun>
+		static void run(size_t count, size_t m, size_t k, size_t n,
+					 bool interleave, const fun& get);
+
+	public:
+
+		matrix_batch(size_t count, size_t rows, size_t cols);
+		matrix_batch(size_t count, size_t rows, size_t cols, const data& val);
+
+		explicit matrix_batch(const std::vector<matrix<data>>& list);
+
+		matrix_batch(void) = default;
+
+		matrix_batch(const matrix_batch<data>& other);
+		matrix_batch(matrix_batch<data>&& other);
+
+		size_t count(void) const;
+		size_t rows(void) const;
+		size_t cols(void) const;
+		size_t stride(void) const;
+
+		bool resize(size_t count, size_t rows, size_t cols);
+		bool clear(void);
+
+		bool is_valid(void) const;
+
+		data* ptr(size_t n);
+		const data* ptr(size_t n) const;
+
+		matrix<data> get(size_t n) const;
+		bool set(size_t n, const matrix<data>& mat);
+
+		data& operator() (size_t n, size_t row, size_t col);
+		const data& operator() (size_t n, size_t row, size_t col) const;
+
+		matrix_batch<data>& operator= (const matrix_batch<data>& other);
+		matrix_batch<data>& operator= (matrix_batch<data>&& other);
+
+		~matrix_batch(void);
+
+		static bool gemm(const matrix_batch<data>& a, const matrix_batch<data>& b, matrix_batch<data>& c,
+					  bool interleave = false, const exec_policy& pol = exec_policy::automatic);
+
+		static bool gemm(const std::vector<matrix<data>>& a, const std::vector<matrix<data>>& b,
+					  std::vector<matrix<data>>& c, bool interleave = false,
+					  const exec_policy& pol = exec_policy::automatic);
+
+};
+
+#ifndef BATCH_CPP
+#include "batch.cpp"
+#endif
+
+#endif // BATCH_HPP
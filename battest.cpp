@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "batch.hpp"
+
+template<typename data>
+bool check(size_t count, size_t m, size_t k, size_t n, bool interleave)
+{
+	std::vector<matrix<data>> a, b, c;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		a.push_back(matrix<data>(m, k)); b.push_back(matrix<data>(k, n));
+
+		for (size_t r = 0; r < m; ++r)
+			for (size_t s = 0; s < k; ++s)
+				a.back()(r, s) = data((i + r * 3 + s) % 7) - data(3);
+
+		for (size_t r = 0; r < k; ++r)
+			for (size_t s = 0; s < n; ++s)
+				b.back()(r, s) = data((i * 5 + r + s * 2) % 5) - data(2);
+	}
+
+	const matrix_batch<data> ba(a), bb(b);
+	matrix_batch<data> bc;
+
+	if (!matrix_batch<data>::gemm(ba, bb, bc, interleave)) return false;
+	if (!matrix_batch<data>::gemm(a, b, c, interleave)) return false;
+
+	if (bc.count() != count || bc.rows() != m || bc.cols() != n || c.size() != count) return false;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const auto ref = a[i] * b[i];
+
+		if (bc.get(i) != ref || c[i] != ref) return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	for (bool inter : { false, true })
+	{
+		if (!check<double>(20, 2, 2, 2, inter)) endtest(n, ok);
+		if (!check<double>(17, 3, 3, 3, inter)) endtest(n, ok);
+		if (!check<float>(33, 8, 8, 8, inter)) endtest(n, ok);
+		if (!check<int>(9, 16, 16, 16, inter)) endtest(n, ok);
+		if (!check<double>(12, 13, 13, 13, inter)) endtest(n, ok);
+		if (!check<double>(11, 4, 6, 5, inter)) endtest(n, ok);
+		if (!check<double>(3, 64, 64, 64, inter)) endtest(n, ok);
+	}
+
+	matrix_batch<double> x(4, 3, 2, 1.0), y(3, 2, 3, 1.0), z;
+
+	if (matrix_batch<double>::gemm(x, y, z) || z.is_valid()) endtest(n, ok);
+
+	matrix_batch<double> w(4, 2, 2, 2.0), v;
+
+	if (!matrix_batch<double>::gemm(w, w, v, true, exec_policy::seq) || v(3, 1, 1) != 8.0) endtest(n, ok);
+
+	const auto u = v;
+
+	if (!w.set(1, matrix<double>(2, 2, 0.5)) || w.set(1, matrix<double>(3, 2)) || w(1, 0, 1) != 0.5) endtest(n, ok);
+	if (u.get(2) != matrix<double>(2, 2, 8.0) || u.get(4).is_valid() || u.stride() != 4) endtest(n, ok);
+
+	std::vector<matrix<double>> a(5, matrix<double>(6, 6, 1.0)), c(5, matrix<double>(6, 6, 0.0));
+
+	alloc_tracker::set_enabled(true);
+
+	const auto before = alloc_tracker::totals().count;
+
+	if (!matrix_batch<double>::gemm(a, a, c) || c[4](5, 5) != 6.0) endtest(n, ok);
+	if (alloc_tracker::totals().count != before) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,264 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <filesystem>
+#include <sstream>
+#include <cstring>
+
+#include "matrix.hpp"
+#include "benchmark.hpp"
+
+template<typename data>
+matrix<data> bench_matrix(size_t rows, size_t cols, unsigned seed)
+{
+	matrix<data> mat(rows, cols);
+
+	for (size_t i = 0; i < rows; ++i)
+		for (size_t j = 0; j < cols; ++j)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const int val = int((seed >> 16) % 200) - 100;
+
+			if constexpr (std::is_integral_v<data>) mat(i, j) = data(val);
+			else mat(i, j) = data(double(val) / 100.0);
+		}
+
+	return mat;
+}
+
+template<typename data>
+void bench_shape(bench_runner& bench, const std::string& type, size_t rows, size_t cols)
+{
+	const auto a = bench_matrix<data>(rows, cols, 1);
+	const auto b = bench_matrix<data>(rows, cols, 2);
+	const auto v = bench_matrix<data>(cols, 1, 3);
+
+	const double count = double(rows) * cols;
+	const double esize = sizeof(data);
+
+	auto c = a;
+
+	bench.run("copy", type, rows, cols, 0.0, 2.0 * count * esize, [&] { c = a; bench_keep(c); });
+	bench.run("fill", type, rows, cols, 0.0, count * esize, [&] { bench_keep(matrix<data>(rows, cols, data(1))); });
+
+	bench.run("add", type, rows, cols, count, 3.0 * count * esize, [&] { bench_keep(a + b); });
+	bench.run("sub", type, rows, cols, count, 3.0 * count * esize, [&] { bench_keep(a - b); });
+	bench.run("add_assign", type, rows, cols, count, 3.0 * count * esize, [&] { bench_keep(c += b); });
+	bench.run("scalar_mul", type, rows, cols, count, 2.0 * count * esize, [&] { bench_keep(a * data(2)); });
+	bench.run("scalar_add", type, rows, cols, count, 2.0 * count * esize, [&] { bench_keep(a + data(2)); });
+	bench.run("negate", type, rows, cols, count, 2.0 * count * esize, [&] { bench_keep(-a); });
+	bench.run("normalize", type, rows, cols, 2.0 * count, 3.0 * count * esize, [&] { bench_keep(a.normalize()); });
+	bench.run("apply", type, rows, cols, count, 2.0 * count * esize, [&]
+	{
+		bench_keep(a.apply([] (data x) { return x * x; }));
+	});
+
+	bench.run("mean", type, rows, cols, count, count * esize, [&] { bench_keep(a.mean()); });
+	bench.run("var", type, rows, cols, 3.0 * count, 2.0 * count * esize, [&] { bench_keep(a.var()); });
+	bench.run("max", type, rows, cols, count, count * esize, [&] { bench_keep(a.max()); });
+	bench.run("min", type, rows, cols, count, count * esize, [&] { bench_keep(a.min()); });
+
+	bench.run("transpose", type, rows, cols, 0.0, 2.0 * count * esize, [&] { bench_keep(a.transpose()); });
+	bench.run("get_row", type, 1, cols, 0.0, 2.0 * cols * esize, [&] { bench_keep(a.get_row(rows / 2)); });
+	bench.run("get_col", type, rows, 1, 0.0, 2.0 * rows * esize, [&] { bench_keep(a.get_col(cols / 2)); });
+
+	if (rows > 1 && cols > 1)
+	{
+		bench.run("submatrix", type, rows, cols, 0.0, 2.0 * count * esize, [&] { bench_keep(a.submatrix(0, 0)); });
+		bench.run("gemv", type, rows, cols, 2.0 * count, (count + cols + rows) * esize, [&] { bench_keep(a * v); });
+	}
+
+	if (rows == cols)
+	{
+		const double flops = 2.0 * count * cols;
+		const double bytes = 3.0 * count * esize;
+
+		bench.run("gemm", type, rows, cols, flops, bytes, [&] { bench_keep(a * b); });
+	}
+
+	if (rows == cols && rows <= 8)
+	{
+		double perm = 1.0; for (size_t i = 2; i <= rows; ++i) perm *= i;
+
+		bench.run("det", type, rows, cols, perm * rows, count * esize, [&] { bench_keep(a.det()); });
+	}
+
+	if constexpr (requires (std::ostream& s, std::istream& i, data x) { s << x; i >> x; })
+	{
+		const auto path = (std::filesystem::temp_directory_path() / "bench_matrix.txt").string();
+
+		bench.run("save", type, rows, cols, 0.0, count * esize, [&] { a.save(path); });
+		bench.run("load", type, rows, cols, 0.0, count * esize, [&] { bench_keep(matrix<data>(path)); });
+
+		std::filesystem::remove(path);
+	}
+}
+
+template<typename data>
+void bench_type(bench_runner& bench, const std::string& type, const std::vector<size_t>& sizes)
+{
+	for (const auto& n : sizes)
+	{
+		bench_shape<data>(bench, type, n, n);
+		bench_shape<data>(bench, type, 1, n * n);
+		bench_shape<data>(bench, type, 4 * n, std::max<size_t>(1, n / 4));
+	}
+}
+
+std::vector<size_t> parse_sizes(const std::string& list)
+{
+	std::vector<size_t> sizes;
+	std::stringstream stream(list);
+	std::string item;
+
+	while (std::getline(stream, item, ','))
+		if (const auto n = std::strtoul(item.c_str(), nullptr, 10); n > 0)
+			sizes.push_back(n);
+
+	return sizes;
+}
+
+int main(int argc, char* args[])
+{
+	std::vector<size_t> sizes = { 8, 64, 256 };
+	std::string types = "int,f16,float,double,ldouble,f128";
+	std::string csv, json, filter, baseline;
+
+	size_t reps = 0, warmup = 0;
+	double mintime = -1.0, tolerance = -1.0;
+	double peak_gflops = 0.0, peak_gbytes = 0.0;
+
+	bool record = false, check = false, quiet = false;
+	bool counters = false, roofline = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = args[i];
+		const char* val = i + 1 < argc ? args[i + 1] : "";
+
+		if (arg == "--sizes") { sizes = parse_sizes(val); ++i; }
+		else if (arg == "--types") { types = val; ++i; }
+		else if (arg == "--filter") { filter = val; ++i; }
+		else if (arg == "--reps") { reps = std::strtoul(val, nullptr, 10); ++i; }
+		else if (arg == "--warmup") { warmup = std::strtoul(val, nullptr, 10); ++i; }
+		else if (arg == "--mintime") { mintime = std::strtod(val, nullptr); ++i; }
+		else if (arg == "--csv") { csv = val; ++i; }
+		else if (arg == "--json") { json = val; ++i; }
+		else if (arg == "--baseline") { baseline = val; ++i; }
+		else if (arg == "--tolerance") { tolerance = std::strtod(val, nullptr); ++i; }
+		else if (arg == "--pin")
+		{
+			if (!bench_runner::pin_thread(std::strtoul(val, nullptr, 10)))
+				std::cerr << "Unable to pin to cpu " << val << std::endl;
+
+			++i;
+		}
+		else if (arg == "--peak-gflops") { peak_gflops = std::strtod(val, nullptr); ++i; }
+		else if (arg == "--peak-gbs") { peak_gbytes = std::strtod(val, nullptr); ++i; }
+		else if (arg == "--counters") counters = true;
+		else if (arg == "--roofline") roofline = true;
+		else if (arg == "--record") record = true;
+		else if (arg == "--check") check = true;
+		else if (arg == "--quiet") quiet = true;
+		else
+		{
+			std::cerr << "Usage: " << args[0] << " [--sizes 8,64,256] "
+					"[--types int,f16,float,double,ldouble,f128] [--filter name,...] "
+					"[--reps n] [--warmup n] [--mintime sec] [--csv path] "
+					"[--json path] [--quiet] [--pin cpu] [--baseline path] "
+					"[--record] [--check] [--tolerance frac] [--counters] "
+					"[--roofline] [--peak-gflops x] [--peak-gbs x]" << std::endl;
+
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	if (baseline.empty()) baseline = bench_runner::default_baseline();
+
+	const auto has = [&types] (const std::string& name)
+	{
+		return ("," + types + ",").find("," + name + ",") != std::string::npos;
+	};
+
+	const auto suite = [&] (bench_runner& bench)
+	{
+		bench.set_filter(filter);
+		bench.set_verbose(!quiet);
+
+		if (reps) bench.set_reps(reps);
+		if (warmup) bench.set_warmup(warmup);
+		if (mintime >= 0.0) bench.set_mintime(mintime);
+		if (tolerance >= 0.0) bench.set_tolerance(tolerance);
+
+		if (counters && !bench.set_counters(true) && !quiet)
+			std::cerr << "Hardware counters unavailable, reporting timing only" << std::endl;
+
+		if (!quiet) bench_runner::print_header(std::cout);
+
+		if (has("int")) bench_type<int>(bench, "int", sizes);
+		if (has("f16")) bench_type<_Float16>(bench, "f16", sizes);
+		if (has("float")) bench_type<float>(bench, "float", sizes);
+		if (has("double")) bench_type<double>(bench, "double", sizes);
+		if (has("ldouble")) bench_type<long double>(bench, "ldouble", sizes);
+		if (has("f128")) bench_type<__float128>(bench, "f128", sizes);
+	};
+
+	bench_runner bench;
+	suite(bench);
+
+	if (roofline) bench.print_roofline(std::cout, peak_gflops, peak_gbytes);
+
+	if (!csv.empty() && !bench.save_csv(csv)) return 1;
+	if (!json.empty() && !bench.save_json(json)) return 1;
+
+	if (check)
+	{
+		const auto base = bench_runner::load_baseline(baseline);
+
+		if (base.empty())
+		{
+			std::cout << "No baseline in " << baseline << ", recording current run" << std::endl;
+
+			return !bench.save_baseline(baseline);
+		}
+
+		for (size_t attempt = 0; attempt < 3; ++attempt)
+		{
+			std::stringstream report;
+
+			if (bench.compare(base, report) == 0)
+			{
+				std::cout << report.str(); return 0;
+			}
+			else if (attempt == 2)
+			{
+				std::cout << report.str(); return 1;
+			}
+
+			bench_runner again;
+			suite(again);
+
+			bench.merge(again);
+		}
+	}
+	else if (record && !bench.save_baseline(baseline)) return 1;
+
+	return 0;
+}
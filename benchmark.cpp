@@ -0,0 +1,597 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BENCHMARK_CPP
+#define BENCHMARK_CPP
+
+#ifndef BENCHMARK_HPP
+#include "benchmark.hpp"
+inline bool bench_runner::save_baseline(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file.precision(9);
+
+	for (const auto& r : m_results)
+	{
+		file << r.name << ' ' << r.type << ' ' << r.rows << ' ' << r.cols << ' '
+			<< r.median << ' ' << r.mad << ' ' << r.min << '\n';
+	}
+
+	return !file.fail();
+}
+
+inline std::vector<bench_result> bench_runner::load_baseline(const std::string& path)
+{
+	std::vector<bench_result> list;
+	std::ifstream file(path);
+	bench_result r;
+
+	while (file >> r.name >> r.type >> r.rows >> r.cols >> r.median >> r.mad >> r.min)
+	{
+		list.push_back(r);
+	}
+
+	return list;
+}
+
+inline std::string bench_runner::default_baseline(void)
+{
+	if (const char* env = std::getenv("MATRIX_BASELINE")) return env;
+
+	std::string host = "local";
+
+	#ifdef __linux__
+	char name[256] = {};
+
+	if (gethostname(name, sizeof(name) - 1) == 0 && name[0]) host = name;
+	#endif
+
+	return "perf_baseline_" + host + ".txt";
+}
+
+inline bool bench_runner::pin_thread(size_t cpu)
+{
+	#ifdef __linux__
+	cpu_set_t set;
+
+	if (cpu >= CPU_SETSIZE) return false;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+	#else
+	return false;
+	#endif
+}
+
+#endif
+
+inline double bench_result::gflops(void) const
+{
+	return median > 0.0 ? flops / median * 1e-9 : 0.0;
+}
+
+inline double bench_result::gbytes(void) const
+{
+	return median > 0.0 ? bytes / median * 1e-9 : 0.0;
+}
+
+inline double bench_result::intensity(void) const
+{
+	return bytes > 0.0 ? flops / bytes : 0.0;
+}
+
+inline double bench_result::per_call(perf_counters::counter c) const
+{
+	return iters ? double(counters.get(c)) / iters : 0.0;
+}
+
+template<typename type>
+inline void bench_keep(const type& val)
+{
+	#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&val) : "memory");
+	#else
+	static volatile const void* sink; sink = &val;
+	inline bool bench_runner::save_baseline(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file.precision(9);
+
+	for (const auto& r : m_results)
+	{
+		file << r.name << ' ' << r.type << ' ' << r.rows << ' ' << r.cols << ' '
+			<< r.median << ' ' << r.mad << ' ' << r.min << '\n';
+	}
+
+	return !file.fail();
+}
+
+inline std::vector<bench_result> bench_runner::load_baseline(const std::string& path)
+{
+	std::vector<bench_result> list;
+	std::ifstream file(path);
+	bench_result r;
+
+	while (file >> r.name >> r.type >> r.rows >> r.cols >> r.median >> r.mad >> r.min)
+	{
+		list.push_back(r);
+	}
+
+	return list;
+}
+
+inline std::string bench_runner::default_baseline(void)
+{
+	if (const char* env = std::getenv("MATRIX_BASELINE")) return env;
+
+	std::string host = "local";
+
+	#ifdef __linux__
+	char name[256] = {};
+
+	if (gethostname(name, sizeof(name) - 1) == 0 && name[0]) host = name;
+	#endif
+
+	return "perf_baseline_" + host + ".txt";
+}
+
+inline bool bench_runner::pin_thread(size_t cpu)
+{
+	#ifdef __linux__
+	cpu_set_t set;
+
+	if (cpu >= CPU_SETSIZE) return false;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+	#else
+	return false;
+	#endif
+}
+
+#endif
+}
+
+inline double bench_runner::median(std::vector<double> vals)
+{
+	if (vals.empty()) return 0.0;
+
+	const size_t mid = vals.size() / 2;
+	std::nth_element(vals.begin(), vals.begin() + mid, vals.end());
+
+	if (vals.size() % 2) return vals[mid];
+
+	const double hi = vals[mid];
+	const double lo = *std::max_element(vals.begin(), vals.begin() + mid);
+
+	return (lo + hi) / 2.0;
+}
+
+template<typename fun>
+const bench_result* bench_runner::run(const std::string& name,
+							   const std::string& type,
+							   size_t rows, size_t cols,
+							   double flops, double bytes,
+							   fun&& f)
+{
+	using namespace std::chrono;
+
+	if (!is_enabled(name)) return nullptr;
+
+	for (size_t i = 0; i < m_warmup; ++i) f();
+
+	size_t iters = 1;
+
+	while (true)
+	{
+		const auto start = steady_clock::now();
+		for (size_t i = 0; i < iters; ++i) f();
+		const auto stop = steady_clock::now();
+
+		const double time = duration<double>(stop - start).count();
+
+		if (time >= m_mintime || iters >= (size_t(1) << 30)) break;
+		else if (time <= 0.0) iters *= 16;
+		else iters = std::max(iters * 2, size_t(iters * m_mintime / time * 1.2));
+	}
+
+	std::vector<double> times(m_reps);
+
+	for (auto& t : times)
+	{
+		const auto start = steady_clock::now();
+		for (size_t i = 0; i < iters; ++i) f();
+		const auto stop = steady_clock::now();
+
+		t = duration<double>(stop - start).count() / iters;
+	}
+
+	bench_result res;
+
+	res.name = name;
+	res.type = type;
+	res.rows = rows;
+	res.cols = cols;
+	res.reps = m_reps;
+	res.iters = iters;
+	res.flops = flops;
+	res.bytes = bytes;
+
+	res.median = median(times);
+	res.min = *std::min_element(times.begin(), times.end());
+
+	for (const auto& t : times) res.mean += t / times.size();
+
+	std::vector<double> dev(times.size());
+
+	for (size_t i = 0; i < times.size(); ++i)
+		dev[i] = std::abs(times[i] - res.median);
+
+	res.mad = median(std::move(dev));
+
+	if (m_counters)
+	{
+		perf_counters::scope scope(*m_counters, res.counters);
+
+		for (size_t i = 0; i < iters; ++i) f();
+	}
+
+	m_results.push_back(res);
+
+	if (m_verbose) print_result(std::cout, res);
+
+	return &m_results.back();
+}
+
+inline bool bench_runner::is_enabled(const std::string& name) const
+{
+	if (m_filter.empty()) return true;
+
+	size_t start = 0;
+
+	while (start <= m_filter.size())
+	{
+		const size_t stop = std::min(m_filter.find(',', start), m_filter.size());
+
+		if (stop > start && name.find(m_filter.substr(start, stop - start)) != std::string::npos) return true;
+		else start = stop + 1;
+	}
+
+	return false;
+}
+
+inline const std::vector<bench_result>& bench_runner::results(void) const
+{
+	return m_results;
+}
+
+inline bool bench_runner::set_filter(const std::string& filter)
+{
+	m_filter = filter; return true;
+}
+
+inline bool bench_runner::set_warmup(size_t warmup)
+{
+	m_warmup = warmup; return true;
+}
+
+inline bool bench_runner::set_reps(size_t reps)
+{
+	if (reps == 0) return false;
+	else m_reps = reps;
+
+	return true;
+}
+
+inline bool bench_runner::set_mintime(double mintime)
+{
+	if (!(mintime >= 0.0)) return false;
+	else m_mintime = mintime;
+
+	return true;
+}
+
+inline bool bench_runner::set_verbose(bool verbose)
+{
+	m_verbose = verbose; return true;
+}
+
+inline bool bench_runner::set_tolerance(double tolerance, double noise)
+{
+	if (!(tolerance >= 0.0) || !(noise >= 0.0)) return false;
+
+	m_tolerance = tolerance;
+	m_noise = noise;
+
+	return true;
+}
+
+inline bool bench_runner::set_counters(bool enabled)
+{
+	if (!enabled) m_counters.reset();
+	else if (!m_counters) m_counters = std::make_unique<perf_counters>();
+
+	return !enabled || m_counters->is_available();
+}
+
+inline bool bench_runner::has_counters(void) const
+{
+	return m_counters && m_counters->is_available();
+}
+
+inline bool bench_runner::is_regression(const bench_result& base, const bench_result& res) const
+{
+	const double limit = std::max(base.median * m_tolerance, m_noise * (base.mad + res.mad));
+
+	return res.median > base.median + limit;
+}
+
+inline size_t bench_runner::compare(const std::vector<bench_result>& base, std::ostream& stream) const
+{
+	size_t fails = 0;
+
+	for (const auto& r : m_results)
+	{
+		const auto b = std::find_if(base.begin(), base.end(), [&r] (const bench_result& b)
+		{
+			return b.name == r.name && b.type == r.type && b.rows == r.rows && b.cols == r.cols;
+		});
+
+		if (b == base.end() || !(b->median > 0.0)) continue;
+
+		const bool fail = is_regression(*b, r);
+		const std::string shape = std::to_string(r.rows) + "x" + std::to_string(r.cols);
+
+		stream << std::left
+			  << std::setw(14) << r.name << std::setw(8) << r.type
+			  << std::setw(14) << shape << std::right << std::fixed
+			  << std::setprecision(2) << std::setw(12) << b->median * 1e6
+			  << std::setw(12) << r.median * 1e6 << std::setw(9)
+			  << (r.median / b->median - 1.0) * 100.0 << '%'
+			  << (fail ? "  REGRESSION" : "") << std::defaultfloat << std::endl;
+
+		fails += fail;
+	}
+
+	return fails;
+}
+
+inline bool bench_runner::merge(const bench_runner& other)
+{
+	if (other.m_results.size() != m_results.size()) return false;
+
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const auto& o = other.m_results[i];
+		auto& r = m_results[i];
+
+		if (o.name != r.name || o.type != r.type || o.rows != r.rows || o.cols != r.cols) return false;
+		else if (o.median < r.median) r = o;
+	}
+
+	return true;
+}
+
+inline void bench_runner::print_header(std::ostream& stream)
+{
+	stream << std::left
+		  << std::setw(14) << "name" << std::setw(8) << "type"
+		  << std::setw(14) << "shape" << std::right
+		  << std::setw(12) << "median[us]" << std::setw(10) << "mad[us]"
+		  << std::setw(12) << "min[us]" << std::setw(10) << "GFLOP/s"
+		  << std::setw(10) << "GB/s" << std::endl;
+}
+
+inline void bench_runner::print_result(std::ostream& stream, const bench_result& res)
+{
+	const std::string shape = std::to_string(res.rows) + "x" + std::to_string(res.cols);
+
+	stream << std::left
+		  << std::setw(14) << res.name << std::setw(8) << res.type
+		  << std::setw(14) << shape << std::right << std::fixed
+		  << std::setprecision(2) << std::setw(12) << res.median * 1e6
+		  << std::setw(10) << res.mad * 1e6 << std::setw(12) << res.min * 1e6
+		  << std::setw(10) << res.gflops() << std::setw(10) << res.gbytes()
+		  << std::defaultfloat << std::endl;
+}
+
+inline bool bench_runner::print(std::ostream& stream) const
+{
+	print_header(stream);
+
+	for (const auto& r : m_results) print_result(stream, r);
+
+	return !stream.fail();
+}
+
+inline bool bench_runner::print_roofline(std::ostream& stream, double peak_gflops, double peak_gbytes) const
+{
+	using counter = perf_counters::counter;
+
+	for (const auto& r : m_results)
+	{
+		peak_gflops = std::max(peak_gflops, r.gflops());
+		peak_gbytes = std::max(peak_gbytes, r.gbytes());
+	}
+
+	stream << "roofline: peak " << peak_gflops << " GFLOP/s, " << peak_gbytes << " GB/s" << std::endl;
+
+	stream << std::left
+		  << std::setw(14) << "name" << std::setw(8) << "type"
+		  << std::setw(14) << "shape" << std::right
+		  << std::setw(10) << "flop/B" << std::setw(10) << "GFLOP/s"
+		  << std::setw(10) << "roof" << std::setw(8) << "eff%"
+		  << std::setw(8) << "bound" << std::setw(8) << "IPC"
+		  << std::setw(10) << "miss%" << std::setw(10) << "LLC GB/s" << std::endl;
+
+	for (const auto& r : m_results)
+	{
+		if (!(r.flops > 0.0) || !(r.bytes > 0.0)) continue;
+
+		const double ai = r.intensity();
+		const double roof = std::min(peak_gflops, ai * peak_gbytes);
+		const std::string shape = std::to_string(r.rows) + "x" + std::to_string(r.cols);
+
+		stream << std::left
+			  << std::setw(14) << r.name << std::setw(8) << r.type
+			  << std::setw(14) << shape << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(10) << ai
+			  << std::setprecision(2) << std::setw(10) << r.gflops()
+			  << std::setw(10) << roof << std::setw(8)
+			  << (roof > 0.0 ? r.gflops() / roof * 100.0 : 0.0)
+			  << std::setw(8) << (ai * peak_gbytes < peak_gflops ? "memory" : "compute");
+
+		if (r.counters.has(counter::instructions))
+		{
+			stream << std::setw(8) << r.counters.ipc()
+				  << std::setw(10) << r.counters.miss_rate() * 100.0
+				  << std::setw(10) << r.counters.bandwidth() * 1e-9;
+		}
+		else stream << std::setw(8) << "-" << std::setw(10) << "-" << std::setw(10) << "-";
+
+		stream << std::defaultfloat << std::endl;
+	}
+
+	return !stream.fail();
+}
+
+inline bool bench_runner::save_csv(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file << "name,type,rows,cols,reps,iters,median,mad,mean,min,gflops,gbytes,"
+		   "cycles,instructions,cache_misses,ipc\n";
+	file.precision(9);
+
+	for (const auto& r : m_results)
+	{
+		file << r.name << ',' << r.type << ',' << r.rows << ',' << r.cols << ','
+			<< r.reps << ',' << r.iters << ',' << r.median << ',' << r.mad << ','
+			<< r.mean << ',' << r.min << ',' << r.gflops() << ',' << r.gbytes() << ','
+			<< r.per_call(perf_counters::counter::cycles) << ','
+			<< r.per_call(perf_counters::counter::instructions) << ','
+			<< r.per_call(perf_counters::counter::cache_misses) << ','
+			<< r.counters.ipc() << '\n';
+	}
+
+	return !file.fail();
+}
+
+inline bool bench_runner::save_json(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file << "[\n";
+	file.precision(9);
+
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const auto& r = m_results[i];
+
+		file << "  {\"name\": \"" << r.name << "\", \"type\": \"" << r.type
+			<< "\", \"rows\": " << r.rows << ", \"cols\": " << r.cols
+			<< ", \"reps\": " << r.reps << ", \"iters\": " << r.iters
+			<< ", \"median\": " << r.median << ", \"mad\": " << r.mad
+			<< ", \"mean\": " << r.mean << ", \"min\": " << r.min
+			<< ", \"gflops\": " << r.gflops() << ", \"gbytes\": " << r.gbytes()
+			<< ", \"cycles\": " << r.per_call(perf_counters::counter::cycles)
+			<< ", \"instructions\": " << r.per_call(perf_counters::counter::instructions)
+			<< ", \"cache_misses\": " << r.per_call(perf_counters::counter::cache_misses)
+			<< ", \"ipc\": " << r.counters.ipc()
+			<< (i + 1 == m_results.size() ? "}\n" : "},\n");
+	}
+
+	file << "]\n";
+
+	return !file.fail();
+}
+
+inline bool bench_runner::save_baseline(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file.precision(9);
+
+	for (const auto& r : m_results)
+	{
+		file << r.name << ' ' << r.type << ' ' << r.rows << ' ' << r.cols << ' '
+			<< r.median << ' ' << r.mad << ' ' << r.min << '\n';
+	}
+
+	return !file.fail();
+}
+
+inline std::vector<bench_result> bench_runner::load_baseline(const std::string& path)
+{
+	std::vector<bench_result> list;
+	std::ifstream file(path);
+	bench_result r;
+
+	while (file >> r.name >> r.type >> r.rows >> r.cols >> r.median >> r.mad >> r.min)
+	{
+		list.push_back(r);
+	}
+
+	return list;
+}
+
+inline std::string bench_runner::default_baseline(void)
+{
+	if (const char* env = std::getenv("MATRIX_BASELINE")) return env;
+
+	std::string host = "local";
+
+	#ifdef __linux__
+	char name[256] = {};
+
+	if (gethostname(name, sizeof(name) - 1) == 0 && name[0]) host = name;
+	#endif
+
+	return "perf_baseline_" + host + ".txt";
+}
+
+inline bool bench_runner::pin_thread(size_t cpu)
+{
+	#ifdef __linux__
+	cpu_set_t set;
+
+	if (cpu >= CPU_SETSIZE) return false;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+	#else
+	return false;
+	#endif
+}
+
+#endif
@@ -0,0 +1,144 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <cmath>
+
+#include <cstddef>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "counters.hpp"
+
+struct bench_result
+{
+	std::string name;
+	std::string type;
+
+	size_t rows = 0;
+	size_t cols = 0;
+
+	size_t reps = 0;
+	size_t iters = 0;
+
+	double median = 0.0;
+	double mad = 0.0;
+	double mean = 0.0;
+	double min = 0.0;
+
+	double flops = 0.0;
+	double bytes = 0.0;
+
+	perf_counters::sample counters;
+
+	double gflops(void) const;
+	double gbytes(void) const;
+	double intensity(void) const;
+	double per_call(perf_counters::counter c) const;
+};
+
+class bench_runner
+{
+
+	protected:
+
+		std::vector<bench_result> m_results;
+		std::string m_filter;
+
+		size_t m_warmup = 2;
+		size_t m_reps = 11;
+
+		double m_mintime = 1e-3;
+		bool m_verbose = true;
+
+		double m_tolerance = 0.15;
+		double m_noise = 4.0;
+
+		std::unique_ptr<perf_counters> m_counters;
+
+		static double median(std::vector<double> vals);
+
+	public:
+
+		template<typename fun>
+		const bench_result* run(const std::string& name,
+						    const std::string& type,
+						    size_t rows, size_t cols,
+						    double flops, double bytes,
+						    fun&& f);
+
+		bool is_enabled(const std::string& name) const;
+
+		const std::vector<bench_result>& results(void) const;
+
+		bool set_filter(const std::string& filter);
+		bool set_warmup(size_t warmup);
+		bool set_reps(size_t reps);
+		bool set_mintime(double mintime);
+		bool set_verbose(bool verbose);
+		bool set_tolerance(double tolerance, double noise = 4.0);
+		bool set_counters(bool enabled);
+
+		bool has_counters(void) const;
+
+		bool is_regression(const bench_result& base, const bench_result& res) const;
+		size_t compare(const std::vector<bench_result>& base, std::ostream& stream) const;
+
+		bool merge(const bench_runner& other);
+
+		bool print(std::ostream& stream) const;
+		bool print_roofline(std::ostream& stream, double peak_gflops = 0.0, double peak_gbytes = 0.0) const;
+
+		bool save_csv(const std::string& path) const;
+		bool save_json(const std::string& path) const;
+		bool save_baseline(const std::string& path) const;
+
+		static std::vector<bench_result> load_baseline(const std::string& path);
+		static std::string default_baseline(void);
+
+		static bool pin_thread(size_t cpu);
+
+		static void print_header(std::ostream& stream);
+		static void print_result(std::ostream& stream, const bench_result& res);
+
+};
+
+template<typename type>
+inline void bench_keep(const type& val);
+
+#ifndef BENCHMARK_CPP
+#include "benchmark.cpp"
+#endif
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix<double> a(5, 7), b(7, 4), c(5, 4, 1.0);
+
+	for (size_t i = 0; i < 7; ++i)
+	{
+		for (size_t j = 0; j < 5; ++j) a(j, i) = double(i * 2 + j) - 5.0;
+		for (size_t j = 0; j < 4; ++j) b(i, j) = double(i + j * 3) / 4.0;
+	}
+
+	const auto ab = a * b;
+	const auto at = a.transpose();
+	const auto bt = b.transpose();
+	const matrix<double, col_major> ac = a, btc = bt;
+
+	matrix<double> r = c;
+
+	if (!matrix<double>::gemm(2.0, a, b, 3.0, r) || r != ab * 2.0 + c * 3.0) endtest(n, ok);
+	if (!matrix<double>::gemm(1.0, at, b, 0.0, r, true) || r != ab) endtest(n, ok);
+	if (!matrix<double>::gemm(1.0, a, bt, 0.0, r, false, true) || r != ab) endtest(n, ok);
+	if (!matrix<double>::gemm(1.0, at, bt, 0.0, r, true, true) || r != ab) endtest(n, ok);
+	if (!matrix<double>::gemm(1.0, ac, btc, 0.0, r, false, true) || r != ab) endtest(n, ok);
+
+	matrix<double, col_major> rc;
+
+	if (!matrix<double, col_major>::gemm(0.5, a, b, 0.0, rc) || rc != ab * 0.5) endtest(n, ok);
+
+	matrix<double, tiled<2>> rt(5, 4, 1.0);
+
+	if (!matrix<double, tiled<2>>::gemm(1.0, a, b, -1.0, rt) || rt != ab - c) endtest(n, ok);
+
+	matrix<double> bad(3, 3, 1.0);
+
+	if (matrix<double>::gemm(1.0, a, a, 0.0, r) || matrix<double>::gemm(1.0, a, b, 1.0, bad)) endtest(n, ok);
+	if (matrix<double>::gemm(1.0, r, b, 0.0, r)) endtest(n, ok);
+
+	matrix<double> y = c, z;
+
+	if (!y.axpy(2.0, c) || y != c * 3.0 || y.axpy(1.0, a)) endtest(n, ok);
+	if (!y.scal(0.5) || y != c * 1.5 || z.scal(2.0)) endtest(n, ok);
+	if (!a.copy_into(z) || z != a || !a.copy_into(rc) || rc != a || a.copy_into(a)) endtest(n, ok);
+
+	alloc_tracker::set_enabled(true);
+
+	matrix<double> x(64, 64, 0.01), w(64, 64, 1.0), v(64, 64, 0.0);
+	const auto before = alloc_tracker::totals().count;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		matrix<double>::gemm(1.0, x, w, 0.0, v);
+		matrix<double>::gemm(1.0, x, v, 1.0, w, true);
+
+		w.axpy(-0.5, v); w.scal(0.5); v.copy_into(x);
+	}
+
+	if (alloc_tracker::totals().count != before || !w.is_valid()) endtest(n, ok);
+
+	return !(n == ok);
+}
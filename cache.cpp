@@ -0,0 +1,183 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef CACHE_CPP
+#define CACHE_CPP
+
+#ifndef CACHE_HPP
+#include "cache.hpp"
+#endif
+
+inline matrix_cache::matrix_cache(size_t limit)
+: m_limit(limit) {}
+
+inline std::string matrix_cache::make_key(const std::string& path,
+								  const std::type_info& type)
+{
+	return path + '\0' + type.name();
+}
+
+inline void matrix_cache::trim(void)
+{
+	while (m_used > m_limit && !m_list.empty())
+	{
+		const auto& last = m_list.back();
+
+		m_used -= last.bytes;
+		m_map.erase(last.key);
+		m_list.pop_back();
+	}
+}
+
+template<typename data>
+matrix_cache::handle<data> matrix_cache::get(const std::string& path)
+{
+	std::error_code ec;
+
+	const auto time = std::filesystem::last_write_time(path, ec);
+	if (ec) return nullptr;
+
+	const auto fsize = std::filesystem::file_size(path, ec);
+	if (ec) return nullptr;
+
+	const std::string key = make_key(path, typeid(data));
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (auto i = m_map.find(key); i != m_map.end())
+		{
+			const auto it = i->second;
+
+			if (it->time == time && it->fsize == fsize)
+			{
+				m_list.splice(m_list.begin(), m_list, it); ++m_hits;
+
+				return std::static_pointer_cast<const matrix<data>>(it->ptr);
+			}
+
+			m_used -= it->bytes;
+			m_list.erase(it);
+			m_map.erase(i);
+		}
+
+		++m_miss;
+	}
+
+	auto mat = std::make_shared<matrix<data>>();
+
+	if (!mat->load(path) || mat->is_empty()) return nullptr;
+
+	const size_t bytes = sizeof(matrix<data>) + (mat->is_inline() ? 0 : mat->size() * sizeof(data));
+	handle<data> out = std::move(mat);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (bytes > m_limit || m_map.count(key)) return out;
+
+	m_list.push_front({ key, time, fsize, out, bytes });
+	m_map.emplace(key, m_list.begin());
+	m_used += bytes;
+
+	trim();
+
+	return out;
+}
+
+template<typename data>
+bool matrix_cache::drop(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto i = m_map.find(make_key(path, typeid(data)));
+	if (i == m_map.end()) return false;
+
+	m_used -= i->second->bytes;
+	m_list.erase(i->second);
+	m_map.erase(i);
+
+	return true;
+}
+
+inline size_t matrix_cache::get_limit(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_limit;
+}
+
+inline bool matrix_cache::set_limit(size_t limit)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_limit = limit; trim();
+
+	return true;
+}
+
+inline size_t matrix_cache::used(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_used;
+}
+
+inline size_t matrix_cache::count(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_list.size();
+}
+
+inline size_t matrix_cache::hits(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_hits;
+}
+
+inline size_t matrix_cache::misses(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_miss;
+}
+
+inline bool matrix_cache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_list.empty()) return false;
+
+	m_map.clear();
+	m_list.clear();
+	m_used = 0;
+
+	return true;
+}
+
+inline matrix_cache& matrix_cache::global(void)
+{
+	static matrix_cache cache;
+
+	return cache;
+}
+
+#endif
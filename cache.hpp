@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <unordered_map>
+#include <filesystem>
+#include <typeinfo>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <list>
+
+#include <cstddef>
+
+#include "matrix.hpp"
+
+class matrix_cache
+{
+
+	public:
+
+		template<typename data>
+		using handle = std::shared_ptr<const matrix<data>>;
+
+	protected:
+
+		struct entry
+		{
+			std::string key;
+
+			std::filesystem::file_time_type time;
+			std::uintmax_t fsize = 0;
+
+			std::shared_ptr<const void> ptr;
+			size_t bytes = 0;
+		};
+
+		using list_type = std::list<entry>;
+
+		mutable std::mutex m_mutex;
+
+		list_type m_list;
+		std::unordered_map<std::string, list_type::iterator> m_map;
+
+		size_t m_limit = size_t(1) << 30;
+		size_t m_used = 0;
+
+		size_t m_hits = 0;
+		size_t m_miss = 0;
+
+		void trim(void);
+
+		static std::string make_key(const std::string& path,
+							   const std::type_info& type);
+
+	public:
+
+		explicit matrix_cache(size_t limit = size_t(1) << 30);
+
+		matrix_cache(const matrix_cache&) = delete;
+		matrix_cache& operator= (const matrix_cache&) = delete;
+
+		template<typename data>
+		handle<data> get(const std::string& path);
+
+		template<typename data>
+		bool drop(const std::string& path);
+
+		size_t get_limit(void) const;
+		bool set_limit(size_t limit);
+
+		size_t used(void) const;
+		size_t count(void) const;
+
+		size_t hits(void) const;
+		size_t misses(void) const;
+
+		bool clear(void);
+
+		static matrix_cache& global(void);
+
+};
+
+#ifndef CACHE_CPP
+#include "cache.cpp"
+#endif
+
+#endif // CACHE_HPP
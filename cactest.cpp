@@ -0,0 +1,65 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "cache.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix_cache cache;
+
+	const matrix<int> a(2, 2, { 1, 2, 3, 4 });
+	const matrix<int> b(3, 3, { 1, 2, 3, 4, 5, 6, 7, 8, 10 });
+
+	a.save("cache_a.txt");
+	b.save("cache_b.txt");
+
+	const auto h1 = cache.get<int>("cache_a.txt");
+	const auto h2 = cache.get<int>("cache_a.txt");
+	const auto h3 = cache.get<double>("cache_a.txt");
+
+	if (!h1 || *h1 != a) endtest(n, ok);
+	if (h1 != h2 || cache.hits() != 1) endtest(n, ok);
+	if (!h3 || (void*) h3.get() == (void*) h1.get()) endtest(n, ok);
+	if (cache.count() != 2 || cache.misses() != 2) endtest(n, ok);
+
+	b.save("cache_a.txt");
+
+	const auto h4 = cache.get<int>("cache_a.txt");
+
+	if (!h4 || h4 == h1 || *h4 != b || *h1 != a) endtest(n, ok);
+	if (cache.get<int>("cache_none.txt")) endtest(n, ok);
+
+	if (!cache.drop<double>("cache_a.txt") || cache.count() != 1) endtest(n, ok);
+
+	cache.set_limit(cache.used());
+	cache.get<int>("cache_b.txt");
+
+	if (cache.count() != 1 || cache.used() > cache.get_limit()) endtest(n, ok);
+	if (!cache.drop<int>("cache_b.txt") || cache.count() != 0) endtest(n, ok);
+
+	return !(n == ok);
+}
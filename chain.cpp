@@ -0,0 +1,269 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef CHAIN_CPP
+#define CHAIN_CPP
+
+#ifndef CHAIN_HPP
+#include "chain.hpp"
+#endif
+
+template<typename data, typename layout>
+matrix_chain<data, layout>::matrix_chain(const matrix<data, layout>& mat)
+{
+	*this *= mat;
+}
+
+template<typename data, typename layout>
+matrix_chain<data, layout>::matrix_chain(matrix<data, layout>&& mat)
+{
+	*this *= std::move(mat);
+}
+
+template<typename data, typename layout>
+bool matrix_chain<data, layout>::is_valid(void) const
+{
+	if (m_list.empty()) return false;
+
+	for (size_t i = 0; i < m_list.size(); ++i)
+	{
+		if (!m_list[i]->is_valid()) return false;
+		else if (i && m_list[i - 1]->cols() != m_list[i]->rows()) return false;
+	}
+
+	return true;
+}
+
+template<typename data, typename layout>
+bool matrix_chain<data, layout>::is_operand(const matrix<data, layout>& mat) const
+{
+	for (const auto& ptr : m_list) if (ptr == &mat) return true;
+
+	return false;
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::plan(void)
+{
+	const size_t n = m_list.size();
+
+	std::vector<size_t> dims(n + 1), cost(n * n, 0);
+
+	for (size_t i = 0; i < n; ++i) dims[i] = m_list[i]->rows();
+	dims[n] = m_list[n - 1]->cols();
+
+	m_split.assign(n * n, 0);
+
+	for (size_t len = 1; len < n; ++len)
+		for (size_t i = 0; i + len < n; ++i)
+		{
+			const size_t j = i + len;
+			size_t& best = cost[i * n + j];
+
+			best = std::numeric_limits<size_t>::max();
+
+			for (size_t k = i; k < j; ++k)
+			{
+				const size_t c = cost[i * n + k] + cost[(k + 1) * n + j] +
+							  dims[i] * dims[k + 1] * dims[j + 1];
+
+				if (c < best) { best = c; m_split[i * n + j] = k; }
+			}
+		}
+
+	return cost[n - 1];
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::acquire(size_t rows, size_t cols)
+{
+	size_t id = m_work.size();
+
+	for (size_t i = 0; i < m_work.size(); ++i) if (!m_busy[i])
+	{
+		if (m_work[i].rows() == rows && m_work[i].cols() == cols) { id = i; break; }
+		else if (id == m_work.size()) id = i;
+	}
+
+	if (id == m_work.size())
+	{
+		m_work.emplace_back();
+		m_busy.push_back(false);
+	}
+
+	m_busy[id] = true;
+
+	return id;
+}
+
+template<typename data, typename layout>
+void matrix_chain<data, layout>::release(size_t id)
+{
+	m_busy[id] = false;
+}
+
+template<typename data, typename layout>
+bool matrix_chain<data, layout>::product(size_t i, size_t j, matrix<data, layout>& out)
+{
+	if (i == j)
+	{
+		out = *m_list[i]; return true;
+	}
+
+	const size_t n = m_list.size();
+	const size_t k = m_split[i * n + j];
+
+	size_t lid = m_work.size(), rid = m_work.size();
+
+	if (k != i)
+	{
+		lid = acquire(m_list[i]->rows(), m_list[k]->cols());
+		if (!product(i, k, m_work[lid])) return false;
+	}
+
+	if (k + 1 != j)
+	{
+		rid = acquire(m_list[k + 1]->rows(), m_list[j]->cols());
+		if (!product(k + 1, j, m_work[rid])) return false;
+	}
+
+	const auto& left = k != i ? m_work[lid] : *m_list[i];
+	const auto& right = k + 1 != j ? m_work[rid] : *m_list[j];
+
+	const bool ok = matrix<data, layout>::gemm(data(1), left, right, data(0), out);
+
+	if (lid != m_work.size()) release(lid);
+	if (rid != m_work.size()) release(rid);
+
+	return ok;
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::length(void) const
+{
+	return m_list.size();
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::rows(void) const
+{
+	return m_list.empty() ? 0 : m_list.front()->rows();
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::cols(void) const
+{
+	return m_list.empty() ? 0 : m_list.back()->cols();
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::cost(void)
+{
+	return is_valid() ? plan() : 0;
+}
+
+template<typename data, typename layout>
+size_t matrix_chain<data, layout>::naive_cost(void) const
+{
+	if (!is_valid()) return 0;
+
+	size_t sum = 0;
+
+	for (size_t i = 1; i < m_list.size(); ++i)
+	{
+		sum += rows() * m_list[i]->rows() * m_list[i]->cols();
+	}
+
+	return sum;
+}
+
+template<typename data, typename layout>
+bool matrix_chain<data, layout>::eval(matrix<data, layout>& out)
+{
+	if (!is_valid()) return false;
+
+	MATRIX_PROFILE_SCOPE("chain", rows() * cols());
+
+	plan();
+
+	if (is_operand(out))
+	{
+		matrix<data, layout> tmp;
+
+		if (!product(0, m_list.size() - 1, tmp)) return false;
+
+		out = std::move(tmp); return true;
+	}
+	else return product(0, m_list.size() - 1, out);
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix_chain<data, layout>::eval(void)
+{
+	matrix<data, layout> res;
+
+	if (!eval(res)) return matrix<data, layout>();
+	else return res;
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix_chain<data, layout>& matrix_chain<data, layout>::operator*= (const matrix<type, other_layout>& other)
+{
+	if constexpr (std::is_same_v<type, data> && std::is_same_v<other_layout, layout>)
+	{
+		m_list.push_back(&other);
+	}
+	else
+	{
+		m_owned.emplace_back(other);
+		m_list.push_back(&m_owned.back());
+	}
+
+	return *this;
+}
+
+template<typename data, typename layout>
+matrix_chain<data, layout>& matrix_chain<data, layout>::operator*= (matrix<data, layout>&& other)
+{
+	m_owned.push_back(std::move(other));
+	m_list.push_back(&m_owned.back());
+
+	return *this;
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix_chain<data, layout> matrix_chain<data, layout>::operator* (const matrix<type, other_layout>& other) &&
+{
+	*this *= other; return std::move(*this);
+}
+
+template<typename data, typename layout>
+matrix_chain<data, layout> matrix_chain<data, layout>::operator* (matrix<data, layout>&& other) &&
+{
+	*this *= std::move(other); return std::move(*this);
+}
+
+template<typename data, typename layout>
+matrix_chain<data, layout>::operator matrix<data, layout>(void)
+{
+	return eval();
+}
+
+#endif
@@ -0,0 +1,98 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef CHAIN_HPP
+#define CHAIN_HPP
+
+#include <utility>
+#include <vector>
+#include <deque>
+
+#include <cstddef>
+#include <limits>
+
+#include "matrix.hpp"
+
+template<typename data = double, typename layout = row_major>
+class matrix_chain
+{
+
+	protected:
+
+		std::vector<const matrix<data, layout>*> m_list;
+		std::deque<matrix<data, layout>> m_owned;
+
+		std::deque<matrix<data, layout>> m_work;
+		std::vector<bool> m_busy;
+
+		std::vector<size_t> m_split;
+
+		bool is_valid(void) const;
+		bool is_operand(const matrix<data, layout>& mat) const;
+
+		size_t plan(void);
+
+		size_t acquire(size_t rows, size_t cols);
+		void release(size_t id);
+
+		bool product(size_t i, size_t j, matrix<data, layout>& out);
+
+	public:
+
+		matrix_chain(const matrix<data, layout>& mat);
+		matrix_chain(matrix<data, layout>&& mat);
+
+		matrix_chain(void) = default;
+
+		matrix_chain(const matrix_chain<data, layout>&) = delete;
+		matrix_chain(matrix_chain<data, layout>&&) = default;
+
+		size_t length(void) const;
+		size_t rows(void) const;
+		size_t cols(void) const;
+
+		size_t cost(void);
+		size_t naive_cost(void) const;
+
+		bool eval(matrix<data, layout>& out);
+		matrix<data, layout> eval(void);
+
+		template<typename type, typename other_layout>
+		matrix_chain<data, layout>& operator*= (const matrix<type, other_layout>& other);
+
+		matrix_chain<data, layout>& operator*= (matrix<data, layout>&& other);
+
+		template<typename type, typename other_layout>
+		matrix_chain<data, layout> operator* (const matrix<type, other_layout>& other) &&;
+
+		matrix_chain<data, layout> operator* (matrix<data, layout>&& other) &&;
+
+		matrix_chain<data, layout>& operator= (const matrix_chain<data, layout>&) = delete;
+		matrix_chain<data, layout>& operator= (matrix_chain<data, layout>&&) = default;
+
+		operator matrix<data, layout>(void);
+
+};
+
+#ifndef CHAIN_CPP
+#include "chain.cpp"
+#endif
+
+#endif // CHAIN_HPP
@@ -0,0 +1,229 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef COUNTERS_CPP
+#define COUNTERS_CPP
+
+#ifndef COUNTERS_HPP
+#include "counters.hpp"
+#endif
+
+inline uint64_t perf_counters::sample::get(counter c) const
+{
+	return values[size_t(c)];
+}
+
+inline bool perf_counters::sample::has(counter c) const
+{
+	return valid[size_t(c)];
+}
+
+inline double perf_counters::sample::ipc(void) const
+{
+	if (!has(counter::cycles) || !has(counter::instructions) || !get(counter::cycles)) return 0.0;
+	else return double(get(counter::instructions)) / double(get(counter::cycles));
+}
+
+inline double perf_counters::sample::miss_rate(void) const
+{
+	if (!has(counter::cache_refs) || !has(counter::cache_misses) || !get(counter::cache_refs)) return 0.0;
+	else return double(get(counter::cache_misses)) / double(get(counter::cache_refs));
+}
+
+inline double perf_counters::sample::bandwidth(size_t line) const
+{
+	if (!has(counter::cache_misses) || time <= 0.0) return 0.0;
+	else return double(get(counter::cache_misses)) * line / time;
+}
+
+inline double perf_counters::sample::gflops(double flops) const
+{
+	return time > 0.0 ? flops / time * 1e-9 : 0.0;
+}
+
+inline perf_counters::sample& perf_counters::sample::operator+= (const sample& other)
+{
+	for (size_t i = 0; i < s_count; ++i)
+	{
+		values[i] += other.values[i];
+		valid[i] = valid[i] || other.valid[i];
+	}
+
+	time += other.time;
+
+	return *this;
+}
+
+inline perf_counters::scope::scope(perf_counters& counters, sample& out)
+: m_counters(counters), m_out(out)
+{
+	m_counters.start();
+}
+
+inline perf_counters::scope::~scope(void)
+{
+	m_counters.stop(m_out);
+}
+
+inline perf_counters::perf_counters(void)
+{
+	m_fd.fill(-1);
+
+	#ifdef __linux__
+	if (std::getenv("MATRIX_NO_COUNTERS")) return;
+
+	static constexpr uint64_t config[s_count] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_REFERENCES,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	for (size_t i = 0; i < s_count; ++i)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config[i];
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.inherit = 1;
+
+		m_fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+	#endif
+}
+
+inline perf_counters::~perf_counters(void)
+{
+	#ifdef __linux__
+	for (const auto& fd : m_fd) if (fd >= 0) close(fd);
+	#endif
+}
+
+inline bool perf_counters::read(std::array<uint64_t, s_count>& values) const
+{
+	bool any = false;
+
+	#ifdef __linux__
+	for (size_t i = 0; i < s_count; ++i)
+	{
+		uint64_t val = 0;
+
+		if (m_fd[i] >= 0 && ::read(m_fd[i], &val, sizeof(val)) == sizeof(val))
+		{
+			values[i] = val; any = true;
+		}
+	}
+	#endif
+
+	return any;
+}
+
+inline bool perf_counters::is_available(void) const
+{
+	for (size_t i = 0; i < s_count; ++i)
+		if (m_fd[i] >= 0) return true;
+
+	return false;
+}
+
+inline bool perf_counters::is_available(counter c) const
+{
+	return m_fd[size_t(c)] >= 0;
+}
+
+inline bool perf_counters::start(void)
+{
+	if (m_running) return false;
+
+	#ifdef __linux__
+	for (const auto& fd : m_fd) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+	#endif
+
+	read(m_start);
+
+	m_time = std::chrono::steady_clock::now();
+	m_running = true;
+
+	return true;
+}
+
+inline bool perf_counters::stop(sample& out)
+{
+	if (!m_running) return false;
+
+	const auto now = std::chrono::steady_clock::now();
+	std::array<uint64_t, s_count> stop = {};
+
+	read(stop);
+
+	#ifdef __linux__
+	for (const auto& fd : m_fd) if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+	#endif
+
+	for (size_t i = 0; i < s_count; ++i)
+	{
+		out.valid[i] = m_fd[i] >= 0;
+		out.values[i] = out.valid[i] ? stop[i] - m_start[i] : 0;
+	}
+
+	out.time = std::chrono::duration<double>(now - m_time).count();
+	m_running = false;
+
+	return true;
+}
+
+inline const char* perf_counters::get_name(counter c)
+{
+	switch (c)
+	{
+		case counter::cycles: return "cycles";
+		case counter::instructions: return "instructions";
+		case counter::cache_refs: return "cache_refs";
+		case counter::cache_misses: return "cache_misses";
+		case counter::branch_misses: return "branch_misses";
+		default: return "unknown";
+	}
+}
+
+inline bool perf_counters::print(std::ostream& stream, const sample& s, double flops)
+{
+	stream << std::fixed << std::setprecision(3)
+		  << "time[ms]: " << s.time * 1e3;
+
+	for (size_t i = 0; i < s_count; ++i)
+		if (s.valid[i]) stream << ", " << get_name(counter(i)) << ": " << s.values[i];
+
+	if (s.has(counter::instructions)) stream << ", ipc: " << s.ipc();
+	if (s.has(counter::cache_misses)) stream << ", GB/s: " << s.bandwidth() * 1e-9;
+	if (flops > 0.0) stream << ", GFLOP/s: " << s.gflops(flops);
+
+	stream << std::defaultfloat << std::endl;
+
+	return !stream.fail();
+}
+
+#endif
@@ -0,0 +1,130 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+class perf_counters
+{
+
+	public:
+
+		enum class counter
+		{
+			cycles,
+			instructions,
+			cache_refs,
+			cache_misses,
+			branch_misses,
+			count
+		};
+
+		static constexpr size_t s_count = size_t(counter::count);
+
+		struct sample
+		{
+			std::array<uint64_t, s_count> values = {};
+			std::array<bool, s_count> valid = {};
+
+			double time = 0.0;
+
+			uint64_t get(counter c) const;
+			bool has(counter c) const;
+
+			double ipc(void) const;
+			double miss_rate(void) const;
+			double bandwidth(size_t line = 64) const;
+			double gflops(double flops) const;
+
+			sample& operator+= (const sample& other);
+		};
+
+		class scope
+		{
+
+			protected:
+
+				perf_counters& m_counters;
+				sample& m_out;
+
+			public:
+
+				scope(perf_counters& counters, sample& out);
+				~scope(void);
+
+				scope(const scope&) = delete;
+				scope& operator= (const scope&) = delete;
+
+		};
+
+	protected:
+
+		std::array<int, s_count> m_fd;
+		std::array<uint64_t, s_count> m_start = {};
+
+		std::chrono::steady_clock::time_point m_time;
+
+		bool m_running = false;
+
+		bool read(std::array<uint64_t, s_count>& values) const;
+
+	public:
+
+		perf_counters(void);
+		~perf_counters(void);
+
+		perf_counters(const perf_counters&) = delete;
+		perf_counters& operator= (const perf_counters&) = delete;
+
+		bool is_available(void) const;
+		bool is_available(counter c) const;
+
+		bool start(void);
+		bool stop(sample& out);
+
+		static const char* get_name(counter c);
+
+		static bool print(std::ostream& stream, const sample& s, double flops = 0.0);
+
+};
+
+#ifndef COUNTERS_CPP
+#include "counters.cpp"
+#endif
+
+#endif // COUNTERS_HPP
@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	alloc_tracker::set_enabled(true);
+	alloc_tracker::reset();
+
+	matrix<double> a(20, 20, 1.0);
+	const auto base = alloc_tracker::totals();
+
+	matrix<double> b = a;
+	const matrix<double> c = a;
+
+	if (!a.is_shared() || !b.is_shared() || alloc_tracker::totals().count != base.count) endtest(n, ok);
+	if (c(3, 3) != 1.0 || !c.is_shared()) endtest(n, ok);
+
+	b(0, 0) = 2.0;
+
+	if (b.is_shared() || std::as_const(a)(0, 0) != 1.0 || c(0, 0) != 1.0 || b(0, 0) != 2.0) endtest(n, ok);
+	if (alloc_tracker::totals().count != base.count + 1) endtest(n, ok);
+
+	matrix<double> d = c;
+
+	d += b; d *= 2.0;
+
+	if (c.mean() != 1.0 || d(0, 0) != 6.0 || d(1, 1) != 4.0) endtest(n, ok);
+
+	matrix<double> e = c;
+	const auto f = std::move(e) - b;
+
+	if (c.mean() != 1.0 || f(0, 0) != -1.0 || f(5, 5) != 0.0) endtest(n, ok);
+
+	matrix<double> g = c;
+
+	if (!g.set_row(2, matrix<double>(1, 20, 7.0)) || c(2, 0) != 1.0 || g(2, 19) != 7.0) endtest(n, ok);
+
+	matrix<double> h = c;
+	std::stringstream stream;
+
+	if (!b.save(stream) || !h.load(stream) || h != b || c(0, 0) != 1.0) endtest(n, ok);
+
+	matrix<double> i = c;
+
+	if (!i.detach() || i.detach() || i != c || i.is_shared()) endtest(n, ok);
+
+	const matrix<double> s(2, 2, 1.0);
+	matrix<double> t = s;
+
+	if (t.is_shared() || !t.is_inline()) endtest(n, ok);
+
+	const auto before = alloc_tracker::totals().count;
+	std::vector<double> sums(4, 0.0);
+	std::vector<std::thread> pool;
+
+	for (size_t k = 0; k < sums.size(); ++k)
+		pool.emplace_back([&, k] (matrix<double> local) { sums[k] = local.mean(); }, c);
+
+	for (auto& th : pool) th.join();
+
+	if (alloc_tracker::totals().count != before) endtest(n, ok);
+	if (std::count(sums.begin(), sums.end(), 1.0) != 4) endtest(n, ok);
+
+	a.clear(); d = matrix<double>(); g.clear();
+
+	if (c.is_shared() || c.mean() != 1.0) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,421 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef FIXED_CPP
+#define FIXED_CPP
+
+#ifndef FIXED_HPP
+#include "fixed.hpp"
+#endif
+
+template<typename data, size_t R, size_t C> template<size_t N, typename fun>
+constexpr void static_matrix<data, R, C>::unroll(const fun& f)
+{
+	[&f] <size_t... I> (std::index_sequence<I...>)
+	{
+		(f(std::integral_constant<size_t, I>()), ...);
+	}
+	(std::make_index_sequence<N>());
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>::static_matrix(const data& val)
+{
+	for (auto& v : m_data) v = val;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>::static_matrix(const std::initializer_list<data>& list)
+{
+	size_t i = 0;
+
+	for (const auto& v : list) if (i < R * C) m_data[i++] = v;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>::static_matrix(const std::initializer_list<std::initializer_list<data>>& list)
+{
+	for (size_t i = 0; const auto& r : list)
+	{
+		for (size_t j = 0; const auto& v : r)
+			if (i < R && j < C) m_data[i * C + j++] = v;
+
+		++i;
+	}
+}
+
+template<typename data, size_t R, size_t C> template<typename type, typename layout>
+static_matrix<data, R, C>::static_matrix(const matrix<type, layout>& other)
+{
+	assign(other);
+}
+
+template<typename data, size_t R, size_t C>
+constexpr size_t static_matrix<data, R, C>::rows(void)
+{
+	return R;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr size_t static_matrix<data, R, C>::cols(void)
+{
+	return C;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr size_t static_matrix<data, R, C>::size(void)
+{
+	return R * C;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data& static_matrix<data, R, C>::get_val(size_t row, size_t col)
+{
+	return m_data[row * C + col];
+}
+
+template<typename data, size_t R, size_t C>
+constexpr const data& static_matrix<data, R, C>::get_val(size_t row, size_t col) const
+{
+	return m_data[row * C + col];
+}
+
+template<typename data, size_t R, size_t C>
+constexpr bool static_matrix<data, R, C>::set_val(size_t row, size_t col, const data& val)
+{
+	if (row >= R || col >= C) return false;
+	else m_data[row * C + col] = val;
+
+	return true;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data* static_matrix<data, R, C>::ptr(void)
+{
+	return m_data;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr const data* static_matrix<data, R, C>::ptr(void) const
+{
+	return m_data;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, 1, C> static_matrix<data, R, C>::get_row(size_t n) const
+{
+	static_matrix<data, 1, C> out;
+
+	unroll<C>([&] (auto j) { out.m_data[j] = m_data[n * C + j]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, 1> static_matrix<data, R, C>::get_col(size_t n) const
+{
+	static_matrix<data, R, 1> out;
+
+	unroll<R>([&] (auto i) { out.m_data[i] = m_data[i * C + n]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, C, R> static_matrix<data, R, C>::transpose(void) const
+{
+	static_matrix<data, C, R> out;
+
+	unroll<R * C>([&] (auto k)
+	{
+		constexpr size_t i = k / C, j = k % C;
+		out.m_data[j * R + i] = m_data[k];
+	});
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R - (R > 1), C - (C > 1)> static_matrix<data, R, C>::submatrix(size_t row, size_t col) const
+{
+	constexpr size_t OR = R - (R > 1), OC = C - (C > 1);
+	static_matrix<data, OR, OC> out;
+
+	unroll<OR * OC>([&] (auto k)
+	{
+		const size_t i = k / OC, j = k % OC;
+		out.m_data[k] = m_data[(i + (OR < R && i >= row)) * C + j + (OC < C && j >= col)];
+	});
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data static_matrix<data, R, C>::det(void) const requires (R == C)
+{
+	const auto& m = m_data;
+
+	if constexpr (R == 1) return m[0];
+	else if constexpr (R == 2) return m[0] * m[3] - m[1] * m[2];
+	else if constexpr (R == 3)
+	{
+		return m[0] * (m[4] * m[8] - m[5] * m[7])
+			- m[1] * (m[3] * m[8] - m[5] * m[6])
+			+ m[2] * (m[3] * m[7] - m[4] * m[6]);
+	}
+	else
+	{
+		data sum = data(0);
+
+		unroll<C>([&] (auto j)
+		{
+			const data part = m[j] * submatrix(0, j).det();
+
+			if constexpr (j % 2) sum -= part;
+			else sum += part;
+		});
+
+		return sum;
+	}
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data static_matrix<data, R, C>::sum(void) const
+{
+	data out = data(0);
+
+	unroll<R * C>([&] (auto k) { out += m_data[k]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data static_matrix<data, R, C>::mean(void) const
+{
+	return sum() / data(R * C);
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data static_matrix<data, R, C>::max(void) const
+{
+	data out = m_data[0];
+
+	unroll<R * C>([&] (auto k) { if (out < m_data[k]) out = m_data[k]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data static_matrix<data, R, C>::min(void) const
+{
+	data out = m_data[0];
+
+	unroll<R * C>([&] (auto k) { if (out > m_data[k]) out = m_data[k]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C> template<typename type, typename layout>
+bool static_matrix<data, R, C>::assign(const matrix<type, layout>& other)
+{
+	if (other.rows() != R || other.cols() != C) return false;
+
+	for (size_t i = 0; i < R; ++i)
+		for (size_t j = 0; j < C; ++j)
+			m_data[i * C + j] = other(i, j);
+
+	return true;
+}
+
+template<typename data, size_t R, size_t C> template<typename type, typename layout>
+matrix<type, layout> static_matrix<data, R, C>::to_matrix(void) const
+{
+	matrix<type, layout> out(R, C);
+
+	for (size_t i = 0; i < R; ++i)
+		for (size_t j = 0; j < C; ++j)
+			out(i, j) = m_data[i * C + j];
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C> template<typename type, typename layout>
+static_matrix<data, R, C>::operator matrix<type, layout>(void) const
+{
+	return to_matrix<type, layout>();
+}
+
+template<typename data, size_t R, size_t C> template<size_t K>
+constexpr static_matrix<data, R, K> static_matrix<data, R, C>::operator* (const static_matrix<data, C, K>& other) const
+{
+	static_matrix<data, R, K> out;
+
+	unroll<R * K>([&] (auto k)
+	{
+		constexpr size_t i = k / K, j = k % K;
+		data sum = data(0);
+
+		unroll<C>([&] (auto l) { sum += m_data[i * C + l] * other.m_data[l * K + j]; });
+
+		out.m_data[k] = sum;
+	});
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator+ (const static_matrix<data, R, C>& other) const
+{
+	return static_matrix<data, R, C>(*this) += other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator- (const static_matrix<data, R, C>& other) const
+{
+	return static_matrix<data, R, C>(*this) -= other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator+= (const static_matrix<data, R, C>& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] += other.m_data[k]; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator-= (const static_matrix<data, R, C>& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] -= other.m_data[k]; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator+ (const data& other) const
+{
+	return static_matrix<data, R, C>(*this) += other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator- (const data& other) const
+{
+	return static_matrix<data, R, C>(*this) -= other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator* (const data& other) const
+{
+	return static_matrix<data, R, C>(*this) *= other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator/ (const data& other) const
+{
+	return static_matrix<data, R, C>(*this) /= other;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator+= (const data& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] += other; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator-= (const data& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] -= other; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator*= (const data& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] *= other; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C>& static_matrix<data, R, C>::operator/= (const data& other)
+{
+	unroll<R * C>([&] (auto k) { m_data[k] /= other; }); return *this;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::operator- (void) const
+{
+	static_matrix<data, R, C> out;
+
+	unroll<R * C>([&] (auto k) { out.m_data[k] = -m_data[k]; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr bool static_matrix<data, R, C>::operator== (const static_matrix<data, R, C>& other) const
+{
+	for (size_t k = 0; k < R * C; ++k)
+		if (m_data[k] != other.m_data[k])
+			return false;
+
+	return true;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr bool static_matrix<data, R, C>::operator!= (const static_matrix<data, R, C>& other) const
+{
+	return !(*this == other);
+}
+
+template<typename data, size_t R, size_t C>
+constexpr data& static_matrix<data, R, C>::operator() (size_t row, size_t col)
+{
+	return m_data[row * C + col];
+}
+
+template<typename data, size_t R, size_t C>
+constexpr const data& static_matrix<data, R, C>::operator() (size_t row, size_t col) const
+{
+	return m_data[row * C + col];
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::gen_zeros(void)
+{
+	return static_matrix<data, R, C>();
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::gen_ones(void)
+{
+	return static_matrix<data, R, C>(data(1));
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> static_matrix<data, R, C>::gen_diag(const data& val) requires (R == C)
+{
+	static_matrix<data, R, C> out;
+
+	unroll<R>([&] (auto i) { out.m_data[i * C + i] = val; });
+
+	return out;
+}
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> operator* (const data& other, const static_matrix<data, R, C>& mat)
+{
+	return mat * other;
+}
+
+#endif
@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+#include "matrix.hpp"
+
+template<typename data, size_t R, size_t C>
+class static_matrix
+{
+
+	static_assert(R > 0 && C > 0, "static_matrix dimensions must be positive");
+
+	template<typename, size_t, size_t> friend class static_matrix;
+
+	public:
+
+		using data_type = data;
+
+	protected:
+
+		data m_data[R * C] = {};
+
+		template<size_t N, typename fun>
+		static constexpr void unroll(const fun& f);
+
+	public:
+
+		constexpr static_matrix(void) = default;
+
+		constexpr explicit static_matrix(const data& val);
+
+		constexpr static_matrix(const std::initializer_list<data>& list);
+		constexpr static_matrix(const std::initializer_list<std::initializer_list<data>>& list);
+
+		template<typename type, typename layout>
+		explicit static_matrix(const matrix<type, layout>& other);
+
+		static constexpr size_t rows(void);
+		static constexpr size_t cols(void);
+		static constexpr size_t size(void);
+
+		constexpr data& get_val(size_t row, size_t col);
+		constexpr const data& get_val(size_t row, size_t col) const;
+		constexpr bool set_val(size_t row, size_t col, const data& val);
+
+		constexpr data* ptr(void);
+		constexpr const data* ptr(void) const;
+
+		constexpr static_matrix<data, 1, C> get_row(size_t n) const;
+		constexpr static_matrix<data, R, 1> get_col(size_t n) const;
+
+		constexpr static_matrix<data, C, R> transpose(void) const;
+		constexpr static_matrix<data, R - (R > 1), C - (C > 1)> submatrix(size_t row, size_t col) const;
+
+		constexpr data det(void) const requires (R == C);
+
+		constexpr data sum(void) const;
+		constexpr data mean(void) const;
+		constexpr data max(void) const;
+		constexpr data min(void) const;
+
+		template<typename type, typename layout>
+		bool assign(const matrix<type, layout>& other);
+
+		template<typename type = data, typename layout = row_major>
+		matrix<type, layout> to_matrix(void) const;
+
+		template<typename type, typename layout>
+		operator matrix<type, layout>(void) const;
+
+		template<size_t K>
+		constexpr static_matrix<data, R, K> operator* (const static_matrix<data, C, K>& other) const;
+
+		constexpr static_matrix<data, R, C> operator+ (const static_matrix<data, R, C>& other) const;
+		constexpr static_matrix<data, R, C> operator- (const static_matrix<data, R, C>& other) const;
+
+		constexpr static_matrix<data, R, C>& operator+= (const static_matrix<data, R, C>& other);
+		constexpr static_matrix<data, R, C>& operator-= (const static_matrix<data, R, C>& other);
+
+		constexpr static_matrix<data, R, C> operator+ (const data& other) const;
+		constexpr static_matrix<data, R, C> operator- (const data& other) const;
+		constexpr static_matrix<data, R, C> operator* (const data& other) const;
+		constexpr static_matrix<data, R, C> operator/ (const data& other) const;
+
+		constexpr static_matrix<data, R, C>& operator+= (const data& other);
+		constexpr static_matrix<data, R, C>& operator-= (const data& other);
+		constexpr static_matrix<data, R, C>& operator*= (const data& other);
+		constexpr static_matrix<data, R, C>& operator/= (const data& other);
+
+		constexpr static_matrix<data, R, C> operator- (void) const;
+
+		constexpr bool operator== (const static_matrix<data, R, C>& other) const;
+		constexpr bool operator!= (const static_matrix<data, R, C>& other) const;
+
+		constexpr data& operator() (size_t row, size_t col);
+		constexpr const data& operator() (size_t row, size_t col) const;
+
+		static constexpr static_matrix<data, R, C> gen_zeros(void);
+		static constexpr static_matrix<data, R, C> gen_ones(void);
+		static constexpr static_matrix<data, R, C> gen_diag(const data& val = data(1)) requires (R == C);
+
+};
+
+template<typename data, size_t R, size_t C>
+constexpr static_matrix<data, R, C> operator* (const data& other, const static_matrix<data, R, C>& mat);
+
+#ifndef FIXED_CPP
+#include "fixed.cpp"
+#endif
+
+#endif // FIXED_HPP
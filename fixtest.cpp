@@ -0,0 +1,70 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "fixed.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	constexpr static_matrix<int, 3, 3> a = {{ 2, 0, 1 }, { 1, 3, 2 }, { 1, 1, 2 }};
+	constexpr static_matrix<int, 3, 2> b = {{ 1, 2 }, { 0, 1 }, { 4, 0 }};
+	constexpr static_matrix<int, 4, 4> c = {{ 1, 2, 0, 1 }, { 3, 1, 1, 0 }, { 0, 2, 1, 4 }, { 2, 0, 3, 1 }};
+
+	constexpr auto ab = a * b;
+	constexpr auto id = static_matrix<int, 3, 3>::gen_diag();
+
+	static_assert(ab(0, 0) == 6 && ab(0, 1) == 4 && ab(2, 0) == 9 && ab(2, 1) == 3);
+	static_assert(a.det() == 6 && (a * id) == a);
+	static_assert(a.transpose()(0, 1) == 1 && a.transpose()(2, 0) == 1);
+	static_assert(a.submatrix(1, 1) == static_matrix<int, 2, 2>{{ 2, 1 }, { 1, 2 }});
+	static_assert((a + a - a) == a && (-a)(0, 0) == -2 && (a * 2)(1, 1) == 6);
+	static_assert(b.get_row(2)(0, 0) == 4 && b.get_col(1)(0, 0) == 2);
+	static_assert(a.sum() == 13 && a.max() == 3 && a.min() == 0);
+
+	const matrix<int> ma = a;
+	const matrix<int> mb = b.to_matrix();
+	const matrix<int> mc = c;
+
+	if (ma.rows() != 3 || ma.cols() != 3 || ma(1, 2) != 2) endtest(n, ok);
+	if (static_matrix<int, 3, 2>(ma * mb) != ab) endtest(n, ok);
+	if (ma.det() != a.det() || mc.det() != c.det()) endtest(n, ok);
+
+	static_matrix<double, 2, 3> d;
+
+	if (d.assign(matrix<double>(3, 2, 1.0)) || d != decltype(d)::gen_zeros()) endtest(n, ok);
+	if (!d.assign(matrix<double>(2, 3, 1.5)) || d.mean() != 1.5) endtest(n, ok);
+
+	static_matrix<double, 3, 3> r = {{ 0.0, -1.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }};
+	const auto rt = r * r.transpose();
+
+	if (rt != decltype(r)::gen_diag() || r.det() != 1.0) endtest(n, ok);
+
+	r *= 2.0; r /= 2.0; r += 1.0; r -= 1.0;
+
+	if (rt != r * r.transpose() || (0.5 * r)(1, 0) != 0.5) endtest(n, ok);
+
+	return !(n == ok);
+}
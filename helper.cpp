@@ -106,6 +106,8 @@ matrix<base> test_diff(const matrix<base>& mat,
 	#pragma omp parallel for default(shared) firstprivate(imat)
 	for (size_t i = 0; i < iters; ++i)
 	{
+		policy_scope scope(exec_policy::seq);
+
 		randomize_matrix(imat, min, max);
 
 		matrix<data> s_imat = imat;
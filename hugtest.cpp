@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const size_t huge = huge_resource::huge_size();
+
+	huge_resource thp(huge, false, true);
+	huge_resource tlb(huge, true, true);
+
+	matrix<double> a(512, 512, 1.5), b(512, 512, 2.0);
+	const auto ref = a + b;
+
+	{
+		resource_scope scope(thp);
+
+		matrix<double> c = a;
+		const auto d = c + b;
+
+		const auto addr = reinterpret_cast<uintptr_t>(&c(0, 0));
+
+		if (c.get_resource() != &thp || addr % huge || thp.mapped() < 2 * huge) endtest(n, ok);
+		if (d != ref || huge_resource::huge_bytes(&c(0, 0)) > thp.mapped()) endtest(n, ok);
+
+		const matrix<double> s(8, 8, 1.0);
+
+		if (thp.mapped() % huge || s.mean() != 1.0 || thp.hugetlb() != 0) endtest(n, ok);
+	}
+
+	if (thp.mapped() != 0 || thp.fallbacks() != 0) endtest(n, ok);
+
+	{
+		resource_scope scope(tlb);
+
+		matrix<double> c = a;
+		c += b;
+
+		if (c != ref || tlb.hugetlb() + tlb.fallbacks() != 1) endtest(n, ok);
+		if (tlb.hugetlb() && huge_resource::huge_bytes(&c(0, 0)) == 0) endtest(n, ok);
+	}
+
+	if (tlb.mapped() != 0 || !tlb.set_hugetlb(false) || tlb.get_hugetlb()) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,69 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <sstream>
+
+#include <cstdlib>
+
+#include "matrix.hpp"
+#include "counters.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix<double> a(64, 64, 1.0), b(64, 64, 2.0);
+	perf_counters::sample s;
+
+	{
+		perf_counters counters;
+		perf_counters::scope scope(counters, s);
+
+		const auto c = a * b;
+	}
+
+	if (s.time <= 0.0 || s.gflops(2.0 * 64 * 64 * 64) <= 0.0) endtest(n, ok);
+
+	if (s.has(perf_counters::counter::instructions))
+	{
+		if (s.get(perf_counters::counter::instructions) == 0 || s.ipc() <= 0.0) endtest(n, ok);
+	}
+
+	setenv("MATRIX_NO_COUNTERS", "1", 1);
+
+	perf_counters none;
+	perf_counters::sample t;
+
+	if (none.is_available() || none.stop(t)) endtest(n, ok);
+	if (!none.start() || none.start() || !none.stop(t)) endtest(n, ok);
+	if (t.has(perf_counters::counter::cycles) || t.ipc() != 0.0 || t.bandwidth() != 0.0) endtest(n, ok);
+
+	s += t;
+
+	std::stringstream out;
+
+	if (!perf_counters::print(out, s, 1e6) || out.str().find("time[ms]") == std::string::npos) endtest(n, ok);
+
+	return !(n == ok);
+}
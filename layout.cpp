@@ -0,0 +1,50 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef LAYOUT_CPP
+#define LAYOUT_CPP
+
+#ifndef LAYOUT_HPP
+#include "layout.hpp"
+#endif
+
+constexpr size_t row_major::index(size_t row, size_t col, size_t, size_t cols)
+{
+	return row * cols + col;
+}
+
+constexpr size_t col_major::index(size_t row, size_t col, size_t rows, size_t)
+{
+	return col * rows + row;
+}
+
+template<size_t size>
+constexpr size_t tiled<size>::index(size_t row, size_t col, size_t rows, size_t cols)
+{
+	const size_t rb = row / size * size;
+	const size_t cb = col / size * size;
+
+	const size_t h = std::min(size, rows - rb);
+	const size_t w = std::min(size, cols - cb);
+
+	return rb * cols + cb * h + (row - rb) * w + (col - cb);
+}
+
+#endif
@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+#include <algorithm>
+
+#include <cstddef>
+
+struct row_major
+{
+	static constexpr bool col_order = false;
+
+	static constexpr size_t index(size_t row, size_t col, size_t rows, size_t cols);
+};
+
+struct col_major
+{
+	static constexpr bool col_order = true;
+
+	static constexpr size_t index(size_t row, size_t col, size_t rows, size_t cols);
+};
+
+template<size_t size = 8>
+struct tiled
+{
+	static_assert(size > 0, "tile size must be positive");
+
+	static constexpr bool col_order = false;
+	static constexpr size_t tile = size;
+
+	static constexpr size_t index(size_t row, size_t col, size_t rows, size_t cols);
+};
+
+#ifndef LAYOUT_CPP
+#include "layout.cpp"
+#endif
+
+#endif // LAYOUT_HPP
@@ -0,0 +1,69 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <sstream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const matrix<double> a = {{ 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 10, 11, 12 }};
+	const matrix<double, col_major> c = {{ 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 10, 11, 12 }};
+	const matrix<double, tiled<2>> t = a;
+
+	if (c != a || t != a || c(3, 1) != 11 || t(2, 2) != 9) endtest(n, ok);
+	if (c.get_col(2) != a.get_col(2) || t.get_row(3) != a.get_row(3)) endtest(n, ok);
+	if (c.transpose() != a.transpose() || t.transpose() != a.transpose()) endtest(n, ok);
+
+	if (c.mean(1, decltype(c)::mode::cols) != 6.5 || t.max(2, decltype(t)::mode::rows) != 9) endtest(n, ok);
+	if (c.min(2, decltype(c)::mode::cols) != 3 || t.max(1, decltype(t)::mode::cols) != 11) endtest(n, ok);
+
+	const matrix<double> b = a.transpose();
+
+	if (a * b != c * b || a * b != a * c.transpose() || a * b != t * t.transpose()) endtest(n, ok);
+	if (matrix<double>(c * b) != a * b) endtest(n, ok);
+
+	const auto idx = c.apply([] (double, size_t i, size_t j, size_t, size_t) { return double(i * 10 + j); });
+	const auto pos = c.apply([] (double, size_t i, size_t) { return double(i); });
+
+	if (idx(3, 2) != 32 || idx(0, 1) != 1 || pos(1, 2) != 5) endtest(n, ok);
+
+	matrix<double, tiled<3>> l;
+	std::stringstream stream;
+
+	if (!c.save(stream) || !l.load(stream) || l != a) endtest(n, ok);
+
+	const matrix<float, col_major> f = a;
+	const matrix<double, tiled<2>> s = c + c - c;
+
+	if (f(1, 2) != 6.0f || s != t || (c * 2.0)(2, 1) != 16) endtest(n, ok);
+
+	matrix<double, col_major> v(2, 3, 0.0);
+
+	if (!v.set_val(1, 2, 5.0) || v.set_val(2, 0, 1.0) || v.get_val(1, 2) != 5.0) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,212 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef LOADER_CPP
+#define LOADER_CPP
+
+#ifndef LOADER_HPP
+#include "loader.hpp"
+#endif
+
+template<typename data>
+matrix_loader<data>::ticket::ticket(std::shared_ptr<state> st, std::shared_ptr<job> jb)
+: m_state(std::move(st)), m_job(std::move(jb)), m_future(m_job->promise.get_future()) {}
+
+template<typename data>
+typename matrix_loader<data>::ticket& matrix_loader<data>::ticket::operator= (ticket&& other)
+{
+	if (&other == this) return *this;
+	else release();
+
+	m_state = std::move(other.m_state);
+	m_job = std::move(other.m_job);
+	m_future = std::move(other.m_future);
+
+	return *this;
+}
+
+template<typename data>
+typename matrix_loader<data>::handle matrix_loader<data>::ticket::get(void)
+{
+	if (!m_future.valid()) return nullptr;
+
+	handle out = m_future.get(); release();
+
+	return out;
+}
+
+template<typename data>
+bool matrix_loader<data>::ticket::is_ready(void) const
+{
+	return m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) ==
+						  std::future_status::ready;
+}
+
+template<typename data>
+bool matrix_loader<data>::ticket::is_valid(void) const
+{
+	return m_future.valid();
+}
+
+template<typename data>
+bool matrix_loader<data>::ticket::release(void)
+{
+	if (!m_state || !m_job) return false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		if (m_job->released) return false;
+		else m_job->released = true;
+
+		if (m_job->loaded) --m_state->ahead;
+	}
+
+	m_state->cond.notify_all();
+
+	return true;
+}
+
+template<typename data>
+matrix_loader<data>::ticket::~ticket(void)
+{
+	release();
+}
+
+template<typename data>
+matrix_loader<data>::matrix_loader(size_t depth, matrix_cache& cache)
+: m_state(std::make_shared<state>())
+{
+	m_state->cache = &cache;
+	m_state->depth = depth ? depth : 1;
+
+	m_thread = std::thread(worker, m_state);
+}
+
+template<typename data>
+void matrix_loader<data>::worker(std::shared_ptr<state> st)
+{
+	std::unique_lock<std::mutex> lock(st->mutex);
+
+	while (true)
+	{
+		st->cond.wait(lock, [&st] (void)
+		{
+			return st->stop || (!st->queue.empty() && st->ahead < st->depth);
+		});
+
+		if (st->stop) break;
+
+		auto jb = std::move(st->queue.front());
+		st->queue.pop_front();
+
+		if (jb->released) { jb->promise.set_value(nullptr); continue; }
+
+		lock.unlock();
+		handle out = st->cache->template get<data>(jb->path);
+		lock.lock();
+
+		jb->loaded = true;
+		if (!jb->released) ++st->ahead;
+
+		jb->promise.set_value(std::move(out));
+	}
+
+	for (auto& jb : st->queue) jb->promise.set_value(nullptr);
+
+	st->queue.clear();
+}
+
+template<typename data>
+typename matrix_loader<data>::ticket matrix_loader<data>::prefetch(const std::string& path)
+{
+	auto jb = std::make_shared<job>(); jb->path = path;
+	ticket out(m_state, jb);
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		if (m_state->stop) jb->promise.set_value(nullptr);
+		else m_state->queue.push_back(std::move(jb));
+	}
+
+	m_state->cond.notify_all();
+
+	return out;
+}
+
+template<typename data>
+std::vector<typename matrix_loader<data>::ticket> matrix_loader<data>::prefetch(const std::vector<std::string>& paths)
+{
+	std::vector<ticket> out;
+	out.reserve(paths.size());
+
+	for (const auto& p : paths) out.push_back(prefetch(p));
+
+	return out;
+}
+
+template<typename data>
+size_t matrix_loader<data>::get_depth(void) const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+
+	return m_state->depth;
+}
+
+template<typename data>
+bool matrix_loader<data>::set_depth(size_t depth)
+{
+	if (depth == 0) return false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		m_state->depth = depth;
+	}
+
+	m_state->cond.notify_all();
+
+	return true;
+}
+
+template<typename data>
+size_t matrix_loader<data>::pending(void) const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+
+	return m_state->queue.size();
+}
+
+template<typename data>
+matrix_loader<data>::~matrix_loader(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+
+		m_state->stop = true;
+	}
+
+	m_state->cond.notify_all();
+
+	if (m_thread.joinable()) m_thread.join();
+}
+
+#endif
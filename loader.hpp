@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef LOADER_HPP
+#define LOADER_HPP
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <deque>
+
+#include <cstddef>
+
+#include "cache.hpp"
+
+template<typename data = double>
+class matrix_loader
+{
+
+	public:
+
+		using handle = matrix_cache::handle<data>;
+
+	protected:
+
+		struct job
+		{
+			std::string path;
+			std::promise<handle> promise;
+
+			bool loaded = false;
+			bool released = false;
+		};
+
+		struct state
+		{
+			std::mutex mutex;
+			std::condition_variable cond;
+
+			std::deque<std::shared_ptr<job>> queue;
+
+			matrix_cache* cache = nullptr;
+
+			size_t depth = 0;
+			size_t ahead = 0;
+
+			bool stop = false;
+		};
+
+		std::shared_ptr<state> m_state;
+		std::thread m_thread;
+
+		static void worker(std::shared_ptr<state> st);
+
+	public:
+
+		class ticket
+		{
+
+			protected:
+
+				std::shared_ptr<state> m_state;
+				std::shared_ptr<job> m_job;
+
+				std::shared_future<handle> m_future;
+
+			public:
+
+				ticket(void) = default;
+				ticket(std::shared_ptr<state> st, std::shared_ptr<job> jb);
+
+				ticket(const ticket&) = delete;
+				ticket(ticket&&) = default;
+
+				ticket& operator= (const ticket&) = delete;
+				ticket& operator= (ticket&& other);
+
+				handle get(void);
+
+				bool is_ready(void) const;
+				bool is_valid(void) const;
+
+				bool release(void);
+
+				~ticket(void);
+
+		};
+
+		explicit matrix_loader(size_t depth = 4,
+						   matrix_cache& cache = matrix_cache::global());
+
+		matrix_loader(const matrix_loader&) = delete;
+		matrix_loader& operator= (const matrix_loader&) = delete;
+
+		ticket prefetch(const std::string& path);
+		std::vector<ticket> prefetch(const std::vector<std::string>& paths);
+
+		size_t get_depth(void) const;
+		bool set_depth(size_t depth);
+
+		size_t pending(void) const;
+
+		~matrix_loader(void);
+
+};
+
+#ifndef LOADER_CPP
+#include "loader.cpp"
+#endif
+
+#endif // LOADER_HPP
@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "loader.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const matrix<int> a(2, 2, { 1, 2, 3, 4 });
+	const matrix<int> b(1, 1, { 5 });
+	const matrix<int> c(2, 1, { 1, 2 });
+
+	a.save("loader_a.txt");
+	b.save("loader_b.txt");
+	c.save("loader_c.txt");
+
+	matrix_cache cache;
+	matrix_loader<int> loader(1, cache);
+
+	auto t = loader.prefetch({ "loader_a.txt", "loader_b.txt",
+						  "loader_none.txt", "loader_c.txt" });
+
+	if (t.size() != 4) endtest(n, ok);
+
+	const auto ha = t[0].get();
+	const auto hb = t[1].get();
+	const auto hn = t[2].get();
+	const auto hc = t[3].get();
+
+	if (!ha || *ha != a) endtest(n, ok);
+	if (!hb || *hb != b) endtest(n, ok);
+	if (!hc || *hc != c) endtest(n, ok);
+	if (hn || t[0].get() != ha) endtest(n, ok);
+
+	auto s = loader.prefetch("loader_a.txt");
+
+	if (s.get() != ha || cache.hits() != 1) endtest(n, ok);
+	if (loader.pending() != 0) endtest(n, ok);
+
+	return !(n == ok);
+}
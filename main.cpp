@@ -42,7 +42,8 @@ void vartestranges(const std::string& wname,
 			    const base max = base(1));
 
 template<typename data, typename base = long double>
-void vartestsingle(const std::vector<int> ndec,
+void vartestsingle(const std::string& wname,
+			    const std::vector<int> ndec,
 			    const std::vector<int> nsam,
 			    const size_t iters = 1e5,
 			    const base min = base(-1),
@@ -86,11 +87,12 @@ void vartestall(const std::string& wname,
 			std::to_string(ndec) + std::string("_") +
 			std::to_string(count) + std::string(".txt");
 
-	const matrix<base> mat(path);
+	const auto mat = matrix_cache::global().get<base>(path);
+	if (!mat) return;
 
-	for (size_t i = 0; i < mat.rows(); ++i)
+	for (size_t i = 0; i < mat->rows(); ++i)
 	{
-		const auto var = test_diff<data, base>(mat.get_row(i), iters, min, max).var();
+		const auto var = test_diff<data, base>(mat->get_row(i), iters, min, max).var();
 		std::cout << std::fixed << (i+1) << '\t' << std::scientific << var << std::endl;
 	}
 }
@@ -111,7 +113,9 @@ void vartestranges(const std::string& wname,
 			std::to_string(count) + std::string(".txt");
 
 	const auto lvls = get_fwt_levels(count, ndec);
-	const matrix<base> mat(path);
+	const auto mat = matrix_cache::global().get<base>(path);
+
+	if (!mat) return;
 
 	for (const auto& [start, stop] : lvls)
 	{
@@ -119,7 +123,7 @@ void vartestranges(const std::string& wname,
 
 		for (size_t i = start; i <= stop; ++i)
 		{
-			var += test_diff<data, base>(mat.get_row(i), iters, min, max).var();
+			var += test_diff<data, base>(mat->get_row(i), iters, min, max).var();
 		}
 
 		var /= (stop - start + 1);
@@ -138,6 +142,24 @@ void vartestsingle(const std::string& wname,
 			    const base min,
 			    const base max)
 {
+	std::vector<std::string> paths;
+	matrix_loader<base> loader;
+
+	for (const auto& i : nsam)
+		for (const auto& j : ndec)
+			if (double(i) / std::pow(2.0, j) >= 1)
+			{
+				paths.push_back(
+						std::string("vec_") +
+						wname + std::string("/") +
+						wname + std::string("_") +
+						std::to_string(j) + std::string("_") +
+						std::to_string(i) + std::string(".txt"));
+			}
+
+	auto tickets = loader.prefetch(paths);
+	auto ticket = tickets.begin();
+
 	std::cout << "nsam";
 	for (const auto& j : ndec) std::cout << std::fixed << "\t" << j;
 	std::cout << std::endl;
@@ -150,16 +172,10 @@ void vartestsingle(const std::string& wname,
 		{
 			if (double(i) / std::pow(2.0, j) >= 1)
 			{
-				const std::string path =
-						std::string("vec_") +
-						wname + std::string("/") +
-						wname + std::string("_") +
-						std::to_string(j) + std::string("_") +
-						std::to_string(i) + std::string(".txt");
-
-				const matrix<base> mat(path);
+				const auto mat = (ticket++)->get();
 
-				std::cout << "\t" << test_diff<data, base>(mat, iters, min, max).var();
+				if (mat) std::cout << "\t" << test_diff<data, base>(*mat, iters, min, max).var();
+				else std::cout << "\t";
 			}
 		}
 
@@ -25,22 +25,22 @@
 #include "matrix.hpp"
 #endif
 
-template<typename data>
-matrix<data>::matrix(const std::string& file)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(const std::string& file)
 {
 	load(file);
 }
 
-template<typename data>
-matrix<data>::matrix(const std::initializer_list<data>& list)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(const std::initializer_list<data>& list)
 {
 	resize(1, list.size()); size_t i = 0;
 
 	for (const auto& n : list) set_val(0, i++, n);
 }
 
-template<typename data>
-matrix<data>::matrix(const std::initializer_list<std::initializer_list<data>>& list)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(const std::initializer_list<std::initializer_list<data>>& list)
 {
 	resize(list.size(), (*list.begin()).size());
 
@@ -50,88 +50,107 @@ matrix<data>::matrix(const std::initializer_list<std::initializer_list<data>>& l
 	}
 }
 
-template<typename data>
-matrix<data>::matrix(size_t rows, size_t cols)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(size_t rows, size_t cols)
 {
 	resize(rows, cols);
 }
 
-template<typename data>
-matrix<data>::matrix(size_t rows, size_t cols, const data ptr[])
+template<typename data, typename layout>
+matrix<data, layout>::matrix(size_t rows, size_t cols, const data ptr[])
 {
 	resize(rows, cols); const size_t count = rows*cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] = ptr[i];
+	parallel::run(count, get_threads(op::copy, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[get_index(i)] = ptr[i];
+	});
 }
 
-template<typename data>
-matrix<data>::matrix(size_t rows, size_t cols, const data& val)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(size_t rows, size_t cols, const data& val)
 {
 	resize(rows, cols); const size_t count = rows*cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] = val;
+	parallel::run(count, get_threads(op::fill, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] = val;
+	});
 }
 
-template<typename data>
-matrix<data>::matrix(size_t rows, size_t cols, const std::initializer_list<data>& list)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(size_t rows, size_t cols, const std::initializer_list<data>& list)
 {
 	resize(rows, cols); const size_t count = rows*cols;
 
 	if (auto j = list.begin(); list.size() == count)
-		for (size_t i = 0; i < count; ++i) m_ptr[i] = *j++;
+		for (size_t i = 0; i < count; ++i) m_ptr[get_index(i)] = *j++;
 }
 
-template<typename data>
-matrix<data>::matrix(const matrix<data>& other)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(const matrix<data, layout>& other)
 {
 	*this = other;
 }
 
-template<typename data>
-matrix<data>::matrix(matrix<data>&& other)
+template<typename data, typename layout>
+matrix<data, layout>::matrix(matrix<data, layout>&& other)
 {
 	*this = std::move(other);
 }
 
-template<typename data> template<typename type>
-matrix<data>::matrix(const matrix<type>& other)
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout>::matrix(const matrix<type, other_layout>& other)
 {
 	*this = other;
 }
 
-template<typename data>
-data& matrix<data>::get_val(size_t row, size_t col)
+template<typename data, typename layout>
+data& matrix<data, layout>::get_val(size_t row, size_t col)
 {
-	return m_ptr[m_cols*row + col];
+#ifdef MATRIX_COW
+	detach();
+#endif
+
+	if constexpr (std::is_same_v<layout, row_major>) return m_ptr[m_cols*row + col];
+	else return m_ptr[layout::index(row, col, m_rows, m_cols)];
 }
 
-template<typename data>
-const data& matrix<data>::get_val(size_t row, size_t col) const
+template<typename data, typename layout>
+const data& matrix<data, layout>::get_val(size_t row, size_t col) const
 {
-	return m_ptr[m_cols*row + col];
+	if constexpr (std::is_same_v<layout, row_major>) return m_ptr[m_cols*row + col];
+	else return m_ptr[layout::index(row, col, m_rows, m_cols)];
 }
 
-template<typename data>
-const data& matrix<data>::get_val(size_t row, size_t col, const data& def) const
+template<typename data, typename layout>
+const data& matrix<data, layout>::get_val(size_t row, size_t col, const data& def) const
 {
 	if (row >= m_rows || col >= m_cols) return def;
-	else return m_ptr[m_cols*row + col];
+	else return get_val(row, col);
 }
 
-template<typename data>
-bool matrix<data>::set_val(size_t row, size_t col, const data& val)
+template<typename data, typename layout>
+bool matrix<data, layout>::set_val(size_t row, size_t col, const data& val)
 {
 	if (row >= m_rows || col >= m_cols) return false;
-	else m_ptr[m_cols*row + col] = val;
+
+#ifdef MATRIX_COW
+	detach();
+#endif
+
+	if constexpr (std::is_same_v<layout, row_major>) m_ptr[m_cols*row + col] = val;
+	else m_ptr[layout::index(row, col, m_rows, m_cols)] = val;
 
 	return true;
 }
 
-template<typename data>
-data matrix<data>::mean(size_t n, mode mod) const
+template<typename data, typename layout>
+data matrix<data, layout>::mean(size_t n, mode mod, const exec_policy& pol) const
 {
+	MATRIX_PROFILE_SCOPE("mean", m_rows * m_cols);
+
+	policy_scope scope(pol);
 	data out = data();
 
 	if (m_ptr == nullptr) return out;
@@ -143,11 +162,14 @@ data matrix<data>::mean(size_t n, mode mod) const
 
 		if (count <= 1) return m_ptr[0];
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < count; ++i)
+		out = parallel::reduce(count, get_threads(op::reduce, count), out, [&] (size_t b, size_t e)
 		{
-			out += m_ptr[i];
-		}
+			data sum = data();
+
+			for (size_t i = b; i < e; ++i) sum += m_ptr[i];
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(count);
 	}
@@ -157,11 +179,14 @@ data matrix<data>::mean(size_t n, mode mod) const
 		if (n >= m_rows) return out;
 		else if (m_cols <= 1) return get_val(n, m_cols);
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < m_cols; ++i)
+		out = parallel::reduce(m_cols, get_threads(op::reduce, m_cols), out, [&] (size_t b, size_t e)
 		{
-			out += get_val(n, i);
-		}
+			data sum = data();
+
+			for (size_t i = b; i < e; ++i) sum += get_val(n, i);
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(m_cols);
 	}
@@ -171,11 +196,14 @@ data matrix<data>::mean(size_t n, mode mod) const
 		if (n >= m_cols) return out;
 		else if (m_rows <= 1) return get_val(m_rows, n);
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < m_rows; ++i)
+		out = parallel::reduce(m_rows, get_threads(op::reduce, m_rows), out, [&] (size_t b, size_t e)
 		{
-			out += get_val(i, n);
-		}
+			data sum = data();
+
+			for (size_t i = b; i < e; ++i) sum += get_val(i, n);
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(m_rows);
 	}
@@ -185,9 +213,12 @@ data matrix<data>::mean(size_t n, mode mod) const
 	return out;
 }
 
-template<typename data>
-data matrix<data>::var(size_t n, mode mod) const
+template<typename data, typename layout>
+data matrix<data, layout>::var(size_t n, mode mod, const exec_policy& pol) const
 {
+	MATRIX_PROFILE_SCOPE("var", m_rows * m_cols);
+
+	policy_scope scope(pol);
 	const data m = mean(n, mod);
 	data out = data();
 
@@ -200,14 +231,20 @@ data matrix<data>::var(size_t n, mode mod) const
 
 		if (count == 1) return data();
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < count; ++i)
+		out = parallel::reduce(count, get_threads(op::reduce, count), out, [&] (size_t b, size_t e)
 		{
-			data diff = m_ptr[i] - m;
+			data sum = data();
 
-			diff = diff * diff;
-			out += diff;
-		}
+			for (size_t i = b; i < e; ++i)
+			{
+				data diff = m_ptr[i] - m;
+
+				diff = diff * diff;
+				sum += diff;
+			}
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(count - 1);
 	}
@@ -217,14 +254,20 @@ data matrix<data>::var(size_t n, mode mod) const
 		if (n >= m_rows) return out;
 		else if (m_cols == 1) return data();
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < m_cols; ++i)
+		out = parallel::reduce(m_cols, get_threads(op::reduce, m_cols), out, [&] (size_t b, size_t e)
 		{
-			data diff = get_val(n, i) - m;
+			data sum = data();
 
-			diff = diff * diff;
-			out += diff;
-		}
+			for (size_t i = b; i < e; ++i)
+			{
+				data diff = get_val(n, i) - m;
+
+				diff = diff * diff;
+				sum += diff;
+			}
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(m_cols - 1);
 	}
@@ -234,14 +277,20 @@ data matrix<data>::var(size_t n, mode mod) const
 		if (n >= m_cols) return out;
 		else if (m_rows == 1) return data();
 
-		#pragma omp parallel for reduction(+:out)
-		for (size_t i = 0; i < m_rows; ++i)
+		out = parallel::reduce(m_rows, get_threads(op::reduce, m_rows), out, [&] (size_t b, size_t e)
 		{
-			data diff = get_val(i, n) - m;
+			data sum = data();
 
-			diff = diff * diff;
-			out += diff;
-		}
+			for (size_t i = b; i < e; ++i)
+			{
+				data diff = get_val(i, n) - m;
+
+				diff = diff * diff;
+				sum += diff;
+			}
+
+			return sum;
+		}, std::plus<data>());
 
 		return out / data(m_rows - 1);
 	}
@@ -251,15 +300,17 @@ data matrix<data>::var(size_t n, mode mod) const
 	return out;
 }
 
-template<typename data>
-data matrix<data>::std(size_t n, mode mod) const
+template<typename data, typename layout>
+data matrix<data, layout>::std(size_t n, mode mod, const exec_policy& pol) const
 {
-	return std::sqrt(var(n, mod));
+	return std::sqrt(var(n, mod, pol));
 }
 
-template<typename data>
-data matrix<data>::max(size_t n, mode mod) const
+template<typename data, typename layout>
+data matrix<data, layout>::max(size_t n, mode mod) const
 {
+	MATRIX_PROFILE_SCOPE("max", m_rows * m_cols);
+
 	if (m_ptr == nullptr) return data();
 	else switch (mod)
 	{
@@ -278,11 +329,10 @@ data matrix<data>::max(size_t n, mode mod) const
 	{
 		if (n >= m_rows) return data();
 
-		size_t ci = n * m_cols + 1;
 		data out = get_val(n, 0);
 
-		for (size_t i = 1; i < m_cols; ++i, ++ci)
-			if (out < m_ptr[ci]) out = m_ptr[ci];
+		for (size_t i = 1; i < m_cols; ++i)
+			if (out < get_val(n, i)) out = get_val(n, i);
 
 		return out;
 	}
@@ -291,11 +341,10 @@ data matrix<data>::max(size_t n, mode mod) const
 	{
 		if (n >= m_cols) return data();
 
-		size_t ci = n + m_cols;
-		data out = get_val(n, 0);
+		data out = get_val(0, n);
 
-		for (size_t i = 1; i < m_rows; ++i, ci += m_cols)
-			if (out < m_ptr[ci]) out = m_ptr[ci];
+		for (size_t i = 1; i < m_rows; ++i)
+			if (out < get_val(i, n)) out = get_val(i, n);
 
 		return out;
 	}
@@ -305,9 +354,11 @@ data matrix<data>::max(size_t n, mode mod) const
 	return data();
 }
 
-template<typename data>
-data matrix<data>::min(size_t n, mode mod) const
+template<typename data, typename layout>
+data matrix<data, layout>::min(size_t n, mode mod) const
 {
+	MATRIX_PROFILE_SCOPE("min", m_rows * m_cols);
+
 	if (m_ptr == nullptr) return data();
 	else switch (mod)
 	{
@@ -326,11 +377,10 @@ data matrix<data>::min(size_t n, mode mod) const
 	{
 		if (n >= m_rows) return data();
 
-		size_t ci = n * m_cols + 1;
 		data out = get_val(n, 0);
 
-		for (size_t i = 1; i < m_cols; ++i, ++ci)
-			if (out > m_ptr[ci]) out = m_ptr[ci];
+		for (size_t i = 1; i < m_cols; ++i)
+			if (out > get_val(n, i)) out = get_val(n, i);
 
 		return out;
 	}
@@ -339,11 +389,10 @@ data matrix<data>::min(size_t n, mode mod) const
 	{
 		if (n >= m_cols) return data();
 
-		size_t ci = n + m_cols;
 		data out = get_val(0, n);
 
-		for (size_t i = 1; i < m_rows; ++i, ci += m_cols)
-			if (out > m_ptr[ci]) out = m_ptr[ci];
+		for (size_t i = 1; i < m_rows; ++i)
+			if (out > get_val(i, n)) out = get_val(i, n);
 
 		return out;
 	}
@@ -353,41 +402,79 @@ data matrix<data>::min(size_t n, mode mod) const
 	return data();
 }
 
-template<typename data>
-data matrix<data>::det(void) const
+template<typename data, typename layout>
+data matrix<data, layout>::det(const exec_policy& pol) const
 {
+	MATRIX_PROFILE_SCOPE("det", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
 	if (m_rows != m_cols) return data();
 	else if (m_rows == 1) return m_ptr[0];
 	else if (m_rows == 2) return
 			m_ptr[0] * m_ptr[3] -
 			m_ptr[1] * m_ptr[2];
 
-	data out = data();
+	size_t work = 1;
 
-	#pragma omp parallel for reduction(+: out)
-	for (size_t i = 0; i < m_rows; ++i)
+	for (size_t i = 2; i <= m_rows && work < (size_t(1) << 40); ++i) work *= i;
+
+	return parallel::reduce(m_rows, get_threads(op::det, m_rows, work), data(), [&] (size_t b, size_t e)
 	{
-		const data mul = (i+1) % 2 ? 1 : -1;
+		data sum = data();
 
-		out += mul * get_val(0, i) * submatrix(0, i).det();
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			const data mul = (i+1) % 2 ? 1 : -1;
 
-	return out;
+			sum += mul * get_val(0, i) * submatrix(0, i).det();
+		}
+
+		return sum;
+	}, std::plus<data>());
 }
 
-template<typename data>
-bool matrix<data>::resize(size_t rows, size_t cols)
+template<typename data, typename layout>
+bool matrix<data, layout>::resize(size_t rows, size_t cols)
 {
 	if (rows == m_rows && cols == m_cols) return false;
 	else if (rows > 0 && cols > 0) clear();
 	else return false;
 
 	const size_t count = cols * rows;
-	void* ptr = std::malloc(count * sizeof(data));
+
+	if (count <= s_inline)
+	{
+		m_ptr = m_local;
+		m_cols = cols;
+		m_rows = rows;
+
+		return true;
+	}
+
+	auto& res = matrix_resource::current();
+
+#ifdef MATRIX_COW
+	void* ptr = res.allocate(s_head + count * sizeof(data), s_align);
 
 	if (ptr)
 	{
+		m_refs = new (ptr) ref_type(1);
+		ptr = static_cast<char*>(ptr) + s_head;
+	}
+#else
+	void* ptr = res.allocate(count * sizeof(data), alignof(data));
+#endif
+
+	if (ptr)
+	{
+		alloc_tracker::allocated(count * sizeof(data));
+
+		if constexpr (std::is_same_v<layout, row_major>) res.touch(ptr, rows, cols * sizeof(data));
+		else res.touch(ptr, count, sizeof(data));
+
 		m_ptr = static_cast<data*>(ptr);
+		m_res = &res;
 		m_cols = cols;
 		m_rows = rows;
 	}
@@ -395,57 +482,115 @@ bool matrix<data>::resize(size_t rows, size_t cols)
 	return m_ptr != nullptr;
 }
 
-template<typename data>
-bool matrix<data>::clear(void)
+template<typename data, typename layout>
+bool matrix<data, layout>::clear(void)
 {
-	if (m_ptr) std::free(m_ptr);
-	else return false;
+	if (m_ptr == nullptr) return false;
+#ifdef MATRIX_COW
+	else if (m_ptr != m_local)
+	{
+		if (m_refs->fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			m_refs->~ref_type();
+			m_res->deallocate(m_refs, s_head + m_rows * m_cols * sizeof(data), s_align);
+			alloc_tracker::released(m_rows * m_cols * sizeof(data));
+		}
+
+		m_refs = nullptr;
+	}
+#else
+	else if (m_ptr != m_local)
+	{
+		m_res->deallocate(m_ptr, m_rows * m_cols * sizeof(data), alignof(data));
+		alloc_tracker::released(m_rows * m_cols * sizeof(data));
+	}
+#endif
 
+	m_ptr = nullptr;
+	m_res = nullptr;
 	m_cols = m_rows = 0;
 
 	return true;
 }
 
-template<typename data>
-bool matrix<data>::is_valid(size_t row, size_t col) const
+template<typename data, typename layout>
+bool matrix<data, layout>::is_valid(size_t row, size_t col) const
 {
 	return row < m_rows && col < m_cols;
 }
 
-template<typename data>
-bool matrix<data>::is_empty(void) const
+template<typename data, typename layout>
+bool matrix<data, layout>::is_empty(void) const
 {
 	return m_ptr == nullptr;
 }
 
-template<typename data>
-bool matrix<data>::is_valid(void) const
+template<typename data, typename layout>
+bool matrix<data, layout>::is_valid(void) const
 {
 	return m_ptr != nullptr;
 }
 
-template<typename data>
-bool matrix<data>::is_vector(void) const
+template<typename data, typename layout>
+bool matrix<data, layout>::is_vector(void) const
 {
 	return m_rows == 1 || m_cols == 1;
 }
 
-template<typename data>
-bool matrix<data>::is_square(void) const
+template<typename data, typename layout>
+bool matrix<data, layout>::is_square(void) const
 {
 	return m_rows == m_cols;
 }
 
-template<typename data>
-bool matrix<data>::load(const std::string& path)
+template<typename data, typename layout>
+bool matrix<data, layout>::is_inline(void) const
+{
+	return m_ptr != nullptr && m_ptr == m_local;
+}
+
+template<typename data, typename layout>
+bool matrix<data, layout>::is_shared(void) const
+{
+#ifdef MATRIX_COW
+	return m_refs && m_refs->load(std::memory_order_acquire) > 1;
+#else
+	return false;
+#endif
+}
+
+template<typename data, typename layout>
+bool matrix<data, layout>::detach(void)
+{
+	if (!is_shared()) return false;
+
+	MATRIX_PROFILE_SCOPE("detach", m_rows * m_cols);
+
+	resource_scope res(*m_res);
+	matrix<data, layout> copy(m_rows, m_cols);
+
+	const size_t count = m_rows * m_cols;
+
+	parallel::run(count, get_threads(op::copy, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) copy.m_ptr[i] = m_ptr[i];
+	});
+
+	*this = std::move(copy);
+
+	return true;
+}
+
+template<typename data, typename layout>
+bool matrix<data, layout>::load(const std::string& path)
 {
 	std::ifstream file(path);
 
 	return load(file);
 }
 
-template<typename data>
-bool matrix<data>::save(const std::string& path, std::streamsize prec) const
+template<typename data, typename layout>
+bool matrix<data, layout>::save(const std::string& path, std::streamsize prec) const
 {
 	std::ofstream file(path, std::ios::trunc);
 	file.precision(prec);
@@ -453,57 +598,51 @@ bool matrix<data>::save(const std::string& path, std::streamsize prec) const
 	return save(file);
 }
 
-template<typename data>
-bool matrix<data>::load(std::istream& stream)
+template<typename data, typename layout>
+bool matrix<data, layout>::load(std::istream& stream)
 {
+	MATRIX_PROFILE_SCOPE("load", 0);
+
 	if (!stream.good()) return false;
 
-	size_t count = 0, cnum = 0, step;
-	size_t length = step = 1024;
+	std::vector<data> buff;
+	size_t cnum = 0;
 	double val = 0.0;
 
-	void* mem = std::malloc(length * sizeof(data));
-	data* ptr = static_cast<data*>(mem);
+	buff.reserve(1024);
 
 	while (stream >> val)
 	{
-		ptr[count++] = val;
-
-		if (count == length)
-		{
-			length += step;
-			mem = std::realloc(ptr, length * sizeof(data));
-			step *= 2;
-
-			if (!mem) { std::free(ptr); return false; }
-			else ptr = static_cast<data*>(mem);
-		}
+		buff.push_back(val);
 
 		if (cnum == 0)
 		{
 			char c = '\0'; stream.get(c);
-			if (c == '\n') cnum = count;
+			if (c == '\n') cnum = buff.size();
 		}
 	}
 
+	size_t count = buff.size();
+
 	if (cnum) count -= count % cnum;
 	else cnum = count;
 
-	if (count) mem = std::realloc(ptr, count * sizeof(data));
-	else if (ptr) { std::free(ptr); mem = ptr = nullptr; }
+	if (count == 0) return false;
+	else resize(count / cnum, cnum);
 
-	if (mem != nullptr) clear(); else return false;
+	if (m_rows * m_cols != count) return false;
+	else detach();
 
-	m_ptr = static_cast<data*>(mem);
-	m_rows = count / cnum;
-	m_cols = cnum;
+	for (size_t i = 0; i < count; ++i) m_ptr[get_index(i)] = buff[i];
 
 	return true;
 }
 
-template<typename data>
-bool matrix<data>::save(std::ostream& stream) const
+template<typename data, typename layout>
+bool matrix<data, layout>::save(std::ostream& stream) const
 {
+	MATRIX_PROFILE_SCOPE("save", m_rows * m_cols);
+
 	if (!stream.good()) return false;
 
 	for (size_t i = 0; i < m_rows; ++i)
@@ -513,125 +652,295 @@ bool matrix<data>::save(std::ostream& stream) const
 	return !stream.fail();
 }
 
-template<typename data>
-size_t matrix<data>::rows(void) const
+template<typename data, typename layout>
+size_t matrix<data, layout>::rows(void) const
 {
 	return m_rows;
 }
 
-template<typename data>
-size_t matrix<data>::cols(void) const
+template<typename data, typename layout>
+size_t matrix<data, layout>::cols(void) const
 {
 	return m_cols;
 }
 
-template<typename data>
-size_t matrix<data>::size(void) const
+template<typename data, typename layout>
+size_t matrix<data, layout>::size(void) const
 {
 	return m_rows * m_cols;
 }
 
-template<typename data>
-size_t matrix<data>::get_ompmin(void) const
+template<typename data, typename layout>
+size_t matrix<data, layout>::get_index(size_t i) const
+{
+	if constexpr (std::is_same_v<layout, row_major>) return i;
+	else return layout::index(i / m_cols, i % m_cols, m_rows, m_cols);
+}
+
+template<typename data, typename layout>
+matrix_resource* matrix<data, layout>::get_resource(void) const
+{
+	return m_res;
+}
+
+template<typename data, typename layout>
+size_t matrix<data, layout>::get_ompmin(void) const
 {
 	return m_ompmin;
 }
 
-template<typename data>
-bool matrix<data>::set_ompmin(size_t ompmin)
+template<typename data, typename layout>
+bool matrix<data, layout>::set_ompmin(size_t ompmin)
 {
 	return m_ompmin = ompmin;
 }
 
-template<typename data>
-matrix<data> matrix<data>::submatrix(size_t row, size_t col) const
+template<typename data, typename layout>
+size_t matrix<data, layout>::get_threads(op o, size_t count, size_t work) const
+{
+	switch (exec_policy::current().get_kind())
+	{
+	case exec_policy::kind::seq: return 1;
+	case exec_policy::kind::automatic: break;
+	default: return parallel::threads();
+	}
+
+	if (m_ompmin) return count > m_ompmin ? parallel::threads() : 1;
+	else return cost_model::global().threads(o, work ? work : count, sizeof(data));
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::submatrix(size_t row, size_t col) const
 {
-	if (m_cols < 2 || m_rows < 2) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("submatrix", m_rows * m_cols);
+
+	if (m_cols < 2 || m_rows < 2) return matrix<data, layout>();
 	else if (row >= m_rows || col >= m_cols) return *this;
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> res(m_rows - 1, m_cols - 1);
+	matrix<data, layout> res(m_rows - 1, m_cols - 1);
 
-	#pragma omp parallel for collapse(2) if(count > m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i)
-		for (size_t j = 0; j < m_cols; ++j)
+	parallel::run(res.m_rows, get_threads(op::submatrix, count), [&] (size_t b, size_t e)
+	{
+		for (size_t r = b; r < e; ++r)
 		{
-			if (i == row || j == col) continue;
+			const size_t i = r < row ? r : r + 1;
 
-			const size_t r = i < row ? i : i - 1;
-			const size_t c = j < col ? j : j - 1;
+			for (size_t j = 0; j < m_cols; ++j)
+			{
+				if (j == col) continue;
+
+				const size_t c = j < col ? j : j - 1;
 
-			res.set_val(r, c, get_val(i, j));
+				res.set_val(r, c, get_val(i, j));
+			}
 		}
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::transpose(void) const
+template<typename data, typename layout>
+void matrix<data, layout>::transpose_block(const data* src, data* dst, size_t rows, size_t cols,
+								   size_t rb, size_t re, size_t cb, size_t ce)
+{
+	const size_t h = re - rb, w = ce - cb;
+
+	if (h <= s_tile && w <= s_tile)
+	{
+		for (size_t j = cb; j < ce; ++j)
+		{
+			data* out = dst + j * rows;
+
+			for (size_t i = rb; i < re; ++i) out[i] = src[i * cols + j];
+		}
+	}
+	else if (h >= w)
+	{
+		transpose_block(src, dst, rows, cols, rb, rb + h / 2, cb, ce);
+		transpose_block(src, dst, rows, cols, rb + h / 2, re, cb, ce);
+	}
+	else
+	{
+		transpose_block(src, dst, rows, cols, rb, re, cb, cb + w / 2);
+		transpose_block(src, dst, rows, cols, rb, re, cb + w / 2, ce);
+	}
+}
+
+template<typename data, typename layout>
+void matrix<data, layout>::transpose_square(data* ptr, size_t size, size_t bi, size_t bj)
+{
+	const size_t rb = bi * s_tile, re = std::min(rb + s_tile, size);
+	const size_t cb = bj * s_tile, ce = std::min(cb + s_tile, size);
+
+	for (size_t i = rb; i < re; ++i)
+		for (size_t j = (bi == bj ? i + 1 : cb); j < ce; ++j)
+			std::swap(ptr[i * size + j], ptr[j * size + i]);
+}
+
+template<typename data, typename layout>
+void matrix<data, layout>::transpose_cycles(data* ptr, size_t rows, size_t cols)
+{
+	const size_t last = rows * cols - 1;
+	std::vector<bool> done(last + 1, false);
+
+	for (size_t start = 1; start < last; ++start)
+	{
+		if (done[start]) continue;
+
+		data val = ptr[start];
+		size_t k = start;
+
+		do
+		{
+			k = k * rows % last;
+
+			std::swap(ptr[k], val);
+			done[k] = true;
+		}
+		while (k != start);
+	}
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::transpose(void) const&
 {
+	MATRIX_PROFILE_SCOPE("transpose", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_cols, m_rows);
+	matrix<data, layout> out(m_cols, m_rows);
 
-	#pragma omp parallel for collapse(2) if(count > m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i)
-		for (size_t j = 0; j < m_cols; ++j)
-			out.set_val(j, i, get_val(i, j));
+	if constexpr (s_linear)
+	{
+		const size_t rows = layout::col_order ? m_cols : m_rows;
+		const size_t cols = layout::col_order ? m_rows : m_cols;
+
+		if (rows == 1 || cols == 1) std::copy(m_ptr, m_ptr + count, out.m_ptr);
+		else parallel::run((rows + s_tile - 1) / s_tile, get_threads(op::transpose, count), [&] (size_t b, size_t e)
+		{
+			transpose_block(m_ptr, out.m_ptr, rows, cols, b * s_tile, std::min(e * s_tile, rows), 0, cols);
+		});
+	}
+	else parallel::run(m_rows, get_threads(op::transpose, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+			for (size_t j = 0; j < m_cols; ++j)
+				out.set_val(j, i, get_val(i, j));
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::normalize(const data& val) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::transpose(void) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	transpose_inplace();
+
+	return std::move(*this);
+}
+
+template<typename data, typename layout>
+bool matrix<data, layout>::transpose_inplace(void)
+{
+	if (m_ptr == nullptr) return false;
+	else if constexpr (!s_linear)
+	{
+		*this = transpose(); return true;
+	}
+
+	MATRIX_PROFILE_SCOPE("transpose", m_rows * m_cols);
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_rows, m_cols);
+	const size_t rows = layout::col_order ? m_cols : m_rows;
+	const size_t cols = layout::col_order ? m_rows : m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
-		out.m_ptr[i] = m_ptr[i] / val;
+	detach();
+
+	if (rows == cols)
+	{
+		const size_t blocks = (rows + s_tile - 1) / s_tile;
+
+		parallel::run(blocks, get_threads(op::transpose, count), [&] (size_t b, size_t e)
+		{
+			for (size_t bi = b; bi < e; ++bi)
+				for (size_t bj = bi; bj < blocks; ++bj)
+					transpose_square(m_ptr, rows, bi, bj);
+		});
+	}
+	else if (rows != 1 && cols != 1) transpose_cycles(m_ptr, rows, cols);
+
+	std::swap(m_rows, m_cols);
+
+	return true;
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::normalize(const data& val) const&
+{
+	MATRIX_PROFILE_SCOPE("normalize", m_rows * m_cols);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
+
+	const size_t count = m_rows * m_cols;
+	matrix<data, layout> out(m_rows, m_cols);
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+			out.m_ptr[i] = m_ptr[i] / val;
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::normalize(const data& val) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::normalize(const data& val) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("normalize", m_rows * m_cols);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)  m_ptr[i] /= val;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)  m_ptr[i] /= val;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::normalize(void) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::normalize(void) const&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("normalize", m_rows * m_cols);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 	data max = m_ptr[0];
 
 	for (size_t i = 1; i < count; ++i)
 		if (max < m_ptr[i]) max = m_ptr[i];
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
-		out.m_ptr[i] = m_ptr[i] / max;
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+			out.m_ptr[i] = m_ptr[i] / max;
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::normalize(void) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::normalize(void) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("normalize", m_rows * m_cols);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 	data max = m_ptr[0];
@@ -639,651 +948,1267 @@ matrix<data> matrix<data>::normalize(void) &&
 	for (size_t i = 1; i < count; ++i)
 		if (max < m_ptr[i]) max = m_ptr[i];
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)  m_ptr[i] /= max;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)  m_ptr[i] /= max;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_a& fun, bool omp) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_a& fun, const exec_policy& pol) const&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 
-	#pragma omp parallel for collapse(2) if(omp && count > m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i)
-		for (size_t j = 0; j < m_cols; ++j)
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
+	{
+		for (size_t k = b, i = b / m_cols, j = b % m_cols; k < e; ++k)
 		{
-			out.get_val(i, j) = fun(get_val(i, j), i, j, m_rows, m_cols);
+			const size_t p = get_index(k);
+
+			out.m_ptr[p] = fun(m_ptr[p], i, j, m_rows, m_cols);
+
+			if (++j == m_cols) { j = 0; ++i; }
 		}
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_a& fun, bool omp) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_a& fun, const exec_policy& pol) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for collapse(2) if(omp && count > m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i)
-		for (size_t j = 0; j < m_cols; ++j)
+	detach();
+
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
+	{
+		for (size_t k = b, i = b / m_cols, j = b % m_cols; k < e; ++k)
 		{
-			get_val(i, j) = fun(get_val(i, j), i, j, m_rows, m_cols);
+			const size_t p = get_index(k);
+
+			m_ptr[p] = fun(m_ptr[p], i, j, m_rows, m_cols);
+
+			if (++j == m_cols) { j = 0; ++i; }
 		}
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_b& fun, bool omp) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_b& fun, const exec_policy& pol) const&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 
-	#pragma omp parallel for if(omp && count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
 	{
-		out.m_ptr[i] = fun(m_ptr[i], i, count);
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			const size_t p = get_index(i);
+
+			out.m_ptr[p] = fun(m_ptr[p], i, count);
+		}
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_b& fun, bool omp) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_b& fun, const exec_policy& pol) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(omp && count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
+	detach();
+
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
 	{
-		m_ptr[i] = fun(m_ptr[i], i, count);
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			const size_t p = get_index(i);
+
+			m_ptr[p] = fun(m_ptr[p], i, count);
+		}
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_c& fun, bool omp) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_c& fun, const exec_policy& pol) const&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 
-	#pragma omp parallel for if(omp && count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
 	{
-		out.m_ptr[i] = fun(m_ptr[i]);
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			out.m_ptr[i] = fun(m_ptr[i]);
+		}
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::apply(const fun_type_c& fun, bool omp) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::apply(const fun_type_c& fun, const exec_policy& pol) &&
 {
-	if (m_ptr == nullptr) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("apply", m_rows * m_cols);
+
+	policy_scope scope(pol);
+
+	if (m_ptr == nullptr) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(omp && count > m_ompmin)
-	for (size_t i = 0; i < count; ++i)
+	detach();
+
+	parallel::run(count, get_threads(op::apply, count), [&] (size_t b, size_t e)
 	{
-		m_ptr[i] = fun(m_ptr[i]);
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			m_ptr[i] = fun(m_ptr[i]);
+		}
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::diagonal(matrix<data>::mode mod) const
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::diagonal(matrix<data, layout>::mode mod) const
 {
-	if (m_rows != m_cols) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("diagonal", m_rows * m_cols);
+
+	if (m_rows != m_cols) return matrix<data, layout>();
 
-	matrix<data> out = mod == mode::rows ?
-					    matrix<data>(1, m_cols) :
-					    matrix<data>(m_rows, 1);
+	matrix<data, layout> out = mod == mode::rows ?
+					    matrix<data, layout>(1, m_cols) :
+					    matrix<data, layout>(m_rows, 1);
 
-	#pragma omp parallel for if(m_cols >= m_ompmin)
-	for (size_t i = 0; i < m_cols; ++i) out.m_ptr[i] = get_val(i, i);
+	parallel::run(m_cols, get_threads(op::copy, m_cols), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) out.m_ptr[i] = get_val(i, i);
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::get_row(size_t n) const
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::get_row(size_t n) const
 {
-	if (n >= m_rows) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("get_row", m_cols);
+
+	if (n >= m_rows) return matrix<data, layout>();
 
-	matrix<data> res(1, m_cols);
+	matrix<data, layout> res(1, m_cols);
 
-	#pragma omp parallel for if(m_cols >= m_ompmin)
-	for (size_t i = 0; i < m_cols; ++i) res.m_ptr[i] = get_val(n, i);
+	parallel::run(m_cols, get_threads(op::copy, m_cols), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = get_val(n, i);
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::get_col(size_t n) const
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::get_col(size_t n) const
 {
-	if (n >= m_cols) return matrix<data>();
+	MATRIX_PROFILE_SCOPE("get_col", m_rows);
 
-	matrix<data> res(m_rows, 1);
+	if (n >= m_cols) return matrix<data, layout>();
 
-	#pragma omp parallel for if(m_rows >= m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i) res.m_ptr[i] = get_val(i, n);
+	matrix<data, layout> res(m_rows, 1);
+
+	parallel::run(m_rows, get_threads(op::copy, m_rows), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = get_val(i, n);
+	});
 
 	return res;
 }
 
-template<typename data>
-data& matrix<data>::operator() (size_t row, size_t col)
+template<typename data, typename layout>
+data& matrix<data, layout>::operator() (size_t row, size_t col)
 {
 	return get_val(row, col);
 }
 
-template<typename data>
-const data& matrix<data>::operator() (size_t row, size_t col) const
+template<typename data, typename layout>
+const data& matrix<data, layout>::operator() (size_t row, size_t col) const
 {
 	return get_val(row, col);
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator- (void) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator- (void) const&
 {
+	MATRIX_PROFILE_SCOPE("negate", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
-	matrix<data> res(m_rows, m_cols);
+	matrix<data, layout> res(m_rows, m_cols);
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) res.m_ptr[i] = -m_ptr[i];
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = -m_ptr[i];
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator- (void) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator- (void) &&
 {
+	MATRIX_PROFILE_SCOPE("negate", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] = -m_ptr[i];
+
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] = -m_ptr[i];
+	});
 
 	return std::move(*this);
 }
 
-template<typename data> template<typename type>
-bool matrix<data>::set_row(size_t n, const matrix<type>& other)
+template<typename data, typename layout> template<typename type>
+bool matrix<data, layout>::set_row(size_t n, const matrix<type, layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("set_row", m_cols);
+
 	if (n >= m_rows) return false;
 	if (other.m_rows != 1 && other.m_cols != 1) return false;
 	if (other.m_rows != m_cols && other.m_cols != m_cols) return false;
 
-	#pragma omp parallel for if(m_cols >= m_ompmin)
-	for (size_t i = 0; i < m_cols; ++i) set_val(n, i, other.m_ptr[i]);
+	detach();
+
+	parallel::run(m_cols, get_threads(op::copy, m_cols), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) set_val(n, i, other.m_ptr[i]);
+	});
 
 	return true;
 }
 
-template<typename data> template<typename type>
-bool matrix<data>::set_col(size_t n, const matrix<type>& other)
+template<typename data, typename layout> template<typename type>
+bool matrix<data, layout>::set_col(size_t n, const matrix<type, layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("set_col", m_rows);
+
 	if (n >= m_cols) return false;
 	if (other.m_rows != 1 && other.m_cols != 1) return false;
 	if (other.m_rows != m_rows && other.m_cols != m_rows) return false;
 
-	#pragma omp parallel for if(m_rows >= m_ompmin)
-	for (size_t i = 0; i < m_rows; ++i) set_val(i, n, other.m_ptr[i]);
+	detach();
+
+	parallel::run(m_rows, get_threads(op::copy, m_rows), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) set_val(i, n, other.m_ptr[i]);
+	});
 
 	return true;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator= (const matrix<type>& other)
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout>& matrix<data, layout>::operator= (const matrix<type, other_layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("copy", other.rows() * other.cols());
+
 	if (static_cast<const void*>(&other) == this) return *this;
-	else resize(other.m_rows, other.m_cols);
+	else if (!resize(other.m_rows, other.m_cols)) detach();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] = other.m_ptr[i];
+	parallel::run(count, get_threads(op::copy, count), [&] (size_t b, size_t e)
+	{
+		if constexpr (std::is_same_v<layout, other_layout>)
+		{
+			for (size_t i = b; i < e; ++i) m_ptr[i] = other.m_ptr[i];
+		}
+		else for (size_t i = b; i < e; ++i)
+		{
+			m_ptr[get_index(i)] = other.m_ptr[other.get_index(i)];
+		}
+	});
 
 	return *this;
 }
 
-template<typename data>
-matrix<data>& matrix<data>::operator= (const matrix<data>& other)
+template<typename data, typename layout>
+matrix<data, layout>& matrix<data, layout>::operator= (const matrix<data, layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("copy", other.m_rows * other.m_cols);
+
 	if (&other == this) return *this;
-	else resize(other.m_rows, other.m_cols);
+
+#ifdef MATRIX_COW
+	if (other.m_refs)
+	{
+		other.m_refs->fetch_add(1, std::memory_order_relaxed);
+		clear();
+
+		m_ptr = other.m_ptr;
+		m_res = other.m_res;
+		m_refs = other.m_refs;
+		m_cols = other.m_cols;
+		m_rows = other.m_rows;
+
+		return *this;
+	}
+#endif
+
+	if (!resize(other.m_rows, other.m_cols)) detach();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] = other.m_ptr[i];
+	parallel::run(count, get_threads(op::copy, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] = other.m_ptr[i];
+	});
 
 	return *this;
 }
 
-template<typename data>
-matrix<data>& matrix<data>::operator= (matrix<data>&& other)
+template<typename data, typename layout>
+matrix<data, layout>& matrix<data, layout>::operator= (matrix<data, layout>&& other)
 {
 	if (&other != this) clear();
 	else return *this;
 
 	m_cols = other.m_cols;
 	m_rows = other.m_rows;
-	m_ptr = other.m_ptr;
+
+	if (other.is_inline())
+	{
+		std::copy(other.m_local, other.m_local + m_rows * m_cols, m_local);
+		m_ptr = m_local;
+	}
+	else
+	{
+		m_ptr = other.m_ptr;
+		m_res = other.m_res;
+#ifdef MATRIX_COW
+		m_refs = other.m_refs;
+		other.m_refs = nullptr;
+#endif
+	}
 
 	other.m_ptr = nullptr;
+	other.m_res = nullptr;
 	other.m_cols = 0;
 	other.m_rows = 0;
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator+ (const matrix<type>& other) const&
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator+ (const matrix<type, layout>& other) const&
 {
+	MATRIX_PROFILE_SCOPE("add", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) out.m_ptr[i] = m_ptr[i] + other.m_ptr[i];
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) out.m_ptr[i] = m_ptr[i] + other.m_ptr[i];
+	});
 
 	return out;
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator+ (matrix<type>&& other) const
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator+ (matrix<type, layout>&& other) const
 {
+	MATRIX_PROFILE_SCOPE("add", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) other.m_ptr[i] += m_ptr[i];
+	other.detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) other.m_ptr[i] += m_ptr[i];
+	});
 
 	return std::move(other);
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator+ (const matrix<type>& other) &&
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator+ (const matrix<type, layout>& other) &&
 {
+	MATRIX_PROFILE_SCOPE("add", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] += other.m_ptr[i];
+	detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] += other.m_ptr[i];
+	});
 
 	return std::move(*this);
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator- (const matrix<type>& other) const&
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator- (const matrix<type, layout>& other) const&
 {
+	MATRIX_PROFILE_SCOPE("sub", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
-	matrix<data> out(m_rows, m_cols);
+	matrix<data, layout> out(m_rows, m_cols);
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) out.m_ptr[i] = m_ptr[i] - other.m_ptr[i];
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) out.m_ptr[i] = m_ptr[i] - other.m_ptr[i];
+	});
 
 	return out;
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator- (matrix<type>&& other) const
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator- (matrix<type, layout>&& other) const
 {
+	MATRIX_PROFILE_SCOPE("sub", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) other.m_ptr[i] -= m_ptr[i];
+	other.detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) other.m_ptr[i] -= m_ptr[i];
+	});
 
 	return std::move(other);
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator- (const matrix<type>& other) &&
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::operator- (const matrix<type, layout>& other) &&
 {
+	MATRIX_PROFILE_SCOPE("sub", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
-	    m_cols != other.m_cols) return matrix<data>();
+	    m_cols != other.m_cols) return matrix<data, layout>();
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] -= other.m_ptr[i];
+	detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] -= other.m_ptr[i];
+	});
 
 	return std::move(*this);
 }
 
-template<typename data> template<typename type>
-matrix<data> matrix<data>::operator* (const matrix<type>& other) const
+template<typename data, typename layout> template<typename type>
+data matrix<data, layout>::dot_kernel(const data* a, const type* b, size_t count)
 {
-	if (m_cols != other.m_rows) return matrix<data>();
+	data s0 = data(0), s1 = data(0), s2 = data(0), s3 = data(0);
+	size_t i = 0;
 
-	matrix<data> res(m_rows, other.m_cols, data(0));
-	const size_t count = res.m_rows * res.m_cols;
+	for (; i + 4 <= count; i += 4)
+	{
+		s0 += a[i + 0] * b[i + 0];
+		s1 += a[i + 1] * b[i + 1];
+		s2 += a[i + 2] * b[i + 2];
+		s3 += a[i + 3] * b[i + 3];
+	}
+
+	for (; i < count; ++i) s0 += a[i] * b[i];
+
+	return (s0 + s1) + (s2 + s3);
+}
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < res.m_rows; ++i)
-		for (size_t k = 0; k < m_cols; ++k)
+template<typename data, typename layout> template<typename type>
+void matrix<data, layout>::gemv_kernel(const data* a, size_t rs, size_t cs, const type* x,
+							    data* y, size_t rows, size_t cols, size_t tnum)
+{
+	parallel::run(rows, tnum, [&] (size_t b, size_t e)
+	{
+		if (cs == 1)
+		{
+			for (size_t i = b; i < e; ++i) y[i] = dot_kernel(a + i * rs, x, cols);
+		}
+		else
 		{
-			const data& mul = m_ptr[i * m_cols + k];
-			for (size_t j = 0; j < res.m_cols; ++j)
+			std::fill(y + b, y + e, data(0));
+
+			for (size_t k = 0; k < cols; ++k)
 			{
-				res(i, j) += mul * other(k, j);
+				const data* col = a + k * cs;
+				const data mul = x[k];
+
+				for (size_t i = b; i < e; ++i) y[i] += col[i] * mul;
 			}
 		}
+	});
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+data matrix<data, layout>::dot(const matrix<type, other_layout>& other) const
+{
+	MATRIX_PROFILE_SCOPE("dot", m_rows * m_cols);
+
+	const size_t count = m_rows * m_cols;
+
+	if (!is_vector() || !other.is_vector() || count != other.size()) return data(0);
+
+	return parallel::reduce(count, get_threads(op::reduce, count), data(0), [&] (size_t b, size_t e)
+	{
+		return dot_kernel(m_ptr + b, other.m_ptr + b, e - b);
+	}, std::plus<data>());
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout> matrix<data, layout>::gemv(const matrix<type, other_layout>& other) const
+{
+	MATRIX_PROFILE_SCOPE("gemv", m_rows * m_cols);
+
+	if (!other.is_vector() || other.size() != m_cols) return matrix<data, layout>();
+
+	matrix<data, layout> res(m_rows, 1);
+	const size_t count = m_rows * m_cols;
+
+	if constexpr (s_linear)
+	{
+		const size_t rs = layout::col_order ? 1 : m_cols;
+		const size_t cs = layout::col_order ? m_rows : 1;
+
+		gemv_kernel(m_ptr, rs, cs, other.m_ptr, res.m_ptr, m_rows, m_cols,
+				  get_threads(op::gemm, m_rows, count));
+	}
+	else parallel::run(m_rows, get_threads(op::gemm, m_rows, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+		{
+			data sum = data(0);
+
+			for (size_t k = 0; k < m_cols; ++k) sum += get_val(i, k) * other.m_ptr[k];
+
+			res.m_ptr[i] = sum;
+		}
+	});
+
+	return res;
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout> matrix<data, layout>::outer(const matrix<type, other_layout>& other) const
+{
+	MATRIX_PROFILE_SCOPE("outer", size() * other.size());
+
+	if (!is_vector() || !other.is_vector()) return matrix<data, layout>();
+
+	const size_t rows = size(), cols = other.size();
+	const size_t count = rows * cols;
+
+	matrix<data, layout> res(rows, cols);
+
+	parallel::run(rows, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+		{
+			const data mul = m_ptr[i];
+
+			if constexpr (std::is_same_v<layout, row_major>)
+			{
+				data* row = res.m_ptr + i * cols;
+
+				for (size_t j = 0; j < cols; ++j) row[j] = mul * other.m_ptr[j];
+			}
+			else for (size_t j = 0; j < cols; ++j) res.get_val(i, j) = mul * other.m_ptr[j];
+		}
+	});
+
+	return res;
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout> matrix<data, layout>::operator* (const matrix<type, other_layout>& other) const
+{
+	MATRIX_PROFILE_SCOPE("gemm", m_rows * other.cols());
+
+	if (m_cols != other.m_rows) return matrix<data, layout>();
+
+	if constexpr (s_linear && matrix<type, other_layout>::s_linear)
+	{
+		if (m_rows == 1 && other.m_cols == 1)
+		{
+			return matrix<data, layout>(1, 1, dot(other));
+		}
+		else if (m_cols == 1 && other.m_rows == 1)
+		{
+			return outer(other);
+		}
+		else if (other.m_cols == 1)
+		{
+			return gemv(other);
+		}
+		else if (m_rows == 1)
+		{
+			matrix<data, layout> res(1, other.m_cols);
+
+			const size_t rs = other_layout::col_order ? other.m_rows : 1;
+			const size_t cs = other_layout::col_order ? 1 : other.m_cols;
+
+			if constexpr (std::is_same_v<type, data>)
+			{
+				gemv_kernel(other.m_ptr, rs, cs, m_ptr, res.m_ptr, other.m_cols, m_cols,
+						  get_threads(op::gemm, other.m_cols, other.m_rows * other.m_cols));
+			}
+			else return matrix<data, layout>(*this) * matrix<data, other_layout>(other);
+
+			return res;
+		}
+	}
+
+	if constexpr (std::is_same_v<type, data> && std::is_same_v<layout, row_major> &&
+			    std::is_same_v<other_layout, row_major>)
+	{
+		if (strassen::is_applicable(m_rows, m_cols, other.m_cols))
+		{
+			const size_t count = m_rows * m_rows;
+
+			matrix<data, layout> res(m_rows, m_rows);
+			std::vector<data> work(strassen::workspace(m_rows));
+
+			if (strassen::multiply(m_ptr, other.m_ptr, res.m_ptr, m_rows, work.data(), work.size(),
+							   get_threads(op::gemm, count, count * m_rows))) return res;
+		}
+	}
+
+	matrix<data, layout> res(m_rows, other.m_cols, data(0));
+	const size_t count = res.m_rows * res.m_cols;
+
+	parallel::run(res.m_rows, get_threads(op::gemm, count, count * m_cols), [&] (size_t b, size_t e)
+	{
+		if constexpr (other_layout::col_order && !layout::col_order)
+		{
+			for (size_t i = b; i < e; ++i)
+				for (size_t j = 0; j < res.m_cols; ++j)
+				{
+					data sum = data(0);
+
+					for (size_t k = 0; k < m_cols; ++k)
+					{
+						sum += get_val(i, k) * other.get_val(k, j);
+					}
+
+					res(i, j) = sum;
+				}
+		}
+		else for (size_t i = b; i < e; ++i)
+			for (size_t k = 0; k < m_cols; ++k)
+			{
+				const data& mul = get_val(i, k);
+				for (size_t j = 0; j < res.m_cols; ++j)
+				{
+					res(i, j) += mul * other.get_val(k, j);
+				}
+			}
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator+ (const data& other) const&
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::add(const matrix<type, layout>& other, const exec_policy& pol) const
+{
+	policy_scope scope(pol);
+
+	return *this + other;
+}
+
+template<typename data, typename layout> template<typename type>
+matrix<data, layout> matrix<data, layout>::sub(const matrix<type, layout>& other, const exec_policy& pol) const
+{
+	policy_scope scope(pol);
+
+	return *this - other;
+}
+
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout> matrix<data, layout>::mul(const matrix<type, other_layout>& other, const exec_policy& pol) const
+{
+	policy_scope scope(pol);
+
+	return *this * other;
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::mul(const data& other, const exec_policy& pol) const
+{
+	policy_scope scope(pol);
+
+	return *this * other;
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator+ (const data& other) const&
 {
-	matrix<data> res(m_rows, m_cols);
+	MATRIX_PROFILE_SCOPE("scalar_add", m_rows * m_cols);
+
+	matrix<data, layout> res(m_rows, m_cols);
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) res.m_ptr[i] = m_ptr[i] + other;
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = m_ptr[i] + other;
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator+ (const data& other) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator+ (const data& other) &&
 {
+	MATRIX_PROFILE_SCOPE("scalar_add", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] += other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] += other;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator- (const data& other) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator- (const data& other) const&
 {
-	matrix<data> res(m_rows, m_cols);
+	MATRIX_PROFILE_SCOPE("scalar_sub", m_rows * m_cols);
+
+	matrix<data, layout> res(m_rows, m_cols);
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) res.m_ptr[i] = m_ptr[i] - other;
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = m_ptr[i] - other;
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator- (const data& other) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator- (const data& other) &&
 {
+	MATRIX_PROFILE_SCOPE("scalar_sub", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] -= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] -= other;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator* (const data& other) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator* (const data& other) const&
 {
-	matrix<data> res(m_rows, m_cols);
+	MATRIX_PROFILE_SCOPE("scalar_mul", m_rows * m_cols);
+
+	matrix<data, layout> res(m_rows, m_cols);
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) res.m_ptr[i] = m_ptr[i] * other;
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = m_ptr[i] * other;
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator* (const data& other) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator* (const data& other) &&
 {
+	MATRIX_PROFILE_SCOPE("scalar_mul", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] *= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] *= other;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator/ (const data& other) const&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator/ (const data& other) const&
 {
-	matrix<data> res(m_rows, m_cols);
+	MATRIX_PROFILE_SCOPE("scalar_div", m_rows * m_cols);
+
+	matrix<data, layout> res(m_rows, m_cols);
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) res.m_ptr[i] = m_ptr[i] / other;
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) res.m_ptr[i] = m_ptr[i] / other;
+	});
 
 	return res;
 }
 
-template<typename data>
-matrix<data> matrix<data>::operator/ (const data& other) &&
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::operator/ (const data& other) &&
 {
+	MATRIX_PROFILE_SCOPE("scalar_div", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] /= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] /= other;
+	});
 
 	return std::move(*this);
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator+= (const matrix<type>& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator+= (const matrix<type, layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("add_assign", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
 	    m_cols != other.m_cols) return *this;
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] += other.m_ptr[i];
+	detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] += other.m_ptr[i];
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator-= (const matrix<type>& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator-= (const matrix<type, layout>& other)
 {
+	MATRIX_PROFILE_SCOPE("sub_assign", m_rows * m_cols);
+
 	if (m_rows != other.m_rows ||
 	    m_cols != other.m_cols) return *this;
 
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] -= other.m_ptr[i];
+	detach();
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] -= other.m_ptr[i];
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator*= (const matrix<type>& other)
+template<typename data, typename layout> template<typename type, typename other_layout>
+matrix<data, layout>& matrix<data, layout>::operator*= (const matrix<type, other_layout>& other)
 {
 	if (m_cols != other.m_rows) return *this;
 	else return *this = *this * other;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator+= (const type& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator+= (const type& other)
 {
+	MATRIX_PROFILE_SCOPE("scalar_add", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] += other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] += other;
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator-= (const type& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator-= (const type& other)
 {
+	MATRIX_PROFILE_SCOPE("scalar_sub", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] -= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] -= other;
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator*= (const type& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator*= (const type& other)
 {
+	MATRIX_PROFILE_SCOPE("scalar_mul", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] *= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] *= other;
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-matrix<data>& matrix<data>::operator/= (const type& other)
+template<typename data, typename layout> template<typename type>
+matrix<data, layout>& matrix<data, layout>::operator/= (const type& other)
 {
+	MATRIX_PROFILE_SCOPE("scalar_div", m_rows * m_cols);
+
 	const size_t count = m_rows * m_cols;
 
-	#pragma omp parallel for if(count > m_ompmin)
-	for (size_t i = 0; i < count; ++i) m_ptr[i] /= other;
+	detach();
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] /= other;
+	});
 
 	return *this;
 }
 
-template<typename data> template<typename type>
-bool matrix<data>::operator== (const matrix<type>& other) const
+template<typename data, typename layout> template<typename type, typename other_layout>
+bool matrix<data, layout>::operator== (const matrix<type, other_layout>& other) const
 {
 	if (m_rows != other.m_rows || m_cols != other.m_cols) return false;
 
 	const size_t count = m_rows * m_cols;
 	for (size_t i = 0; i < count; ++i)
-		if (m_ptr[i] != other.m_ptr[i])
+		if (m_ptr[get_index(i)] != other.m_ptr[other.get_index(i)])
 			return false;
 
 	return true;
 }
 
-template<typename data> template<typename type>
-bool matrix<data>::operator!= (const matrix<type>& other) const
+template<typename data, typename layout> template<typename type, typename other_layout>
+bool matrix<data, layout>::operator!= (const matrix<type, other_layout>& other) const
 {
 	if (m_rows != other.m_rows || m_cols != other.m_cols) return true;
 
 	const size_t count = m_rows * m_cols;
 	for (size_t i = 0; i < count; ++i)
-		if (m_ptr[i] != other.m_ptr[i])
+		if (m_ptr[get_index(i)] != other.m_ptr[other.get_index(i)])
 			return true;
 
 	return false;
 }
 
-template<typename data>
-matrix<data>::~matrix(void)
+template<typename data, typename layout>
+matrix<data, layout>::~matrix(void)
 {
-	if (m_ptr) std::free(m_ptr);
+	clear();
 }
 
-template<typename data>
-matrix<data> matrix<data>::gen_zeros(size_t rows, size_t cols)
+template<typename data, typename layout> template<typename type>
+bool matrix<data, layout>::axpy(const data& alpha, const matrix<type, layout>& x)
 {
-	return matrix<data>(rows, cols, data(0));
+	MATRIX_PROFILE_SCOPE("axpy", m_rows * m_cols);
+
+	if (m_rows != x.m_rows || m_cols != x.m_cols || m_ptr == nullptr) return false;
+	else detach();
+
+	const size_t count = m_rows * m_cols;
+
+	parallel::run(count, get_threads(op::elementwise, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] += alpha * x.m_ptr[i];
+	});
+
+	return true;
 }
 
-template<typename data>
-matrix<data> matrix<data>::gen_ones(size_t rows, size_t cols)
+template<typename data, typename layout>
+bool matrix<data, layout>::scal(const data& alpha)
 {
-	return matrix<data>(rows, cols, data(1));
+	MATRIX_PROFILE_SCOPE("scal", m_rows * m_cols);
+
+	if (m_ptr == nullptr) return false;
+	else detach();
+
+	const size_t count = m_rows * m_cols;
+
+	parallel::run(count, get_threads(op::scalar, count), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) m_ptr[i] *= alpha;
+	});
+
+	return true;
+}
+
+template<typename data, typename layout> template<typename other_layout>
+bool matrix<data, layout>::copy_into(matrix<data, other_layout>& out) const
+{
+	if (m_ptr == nullptr || static_cast<const void*>(&out) == this) return false;
+	else if (!out.resize(m_rows, m_cols)) out.detach();
+
+	MATRIX_PROFILE_SCOPE("copy", m_rows * m_cols);
+
+	const size_t count = m_rows * m_cols;
+
+	parallel::run(count, get_threads(op::copy, count), [&] (size_t b, size_t e)
+	{
+		if constexpr (std::is_same_v<layout, other_layout>)
+		{
+			std::copy(m_ptr + b, m_ptr + e, out.m_ptr + b);
+		}
+		else for (size_t i = b; i < e; ++i)
+		{
+			out.m_ptr[out.get_index(i)] = m_ptr[get_index(i)];
+		}
+	});
+
+	return true;
+}
+
+template<typename data, typename layout> template<typename layout_a, typename layout_b>
+bool matrix<data, layout>::gemm(const data& alpha, const matrix<data, layout_a>& a,
+						  const matrix<data, layout_b>& b, const data& beta, matrix<data, layout>& c,
+						  bool ta, bool tb, const exec_policy& pol)
+{
+	if constexpr (!matrix<data, layout_a>::s_linear || !matrix<data, layout_b>::s_linear || !s_linear)
+	{
+		matrix<data> tmp;
+
+		if (!c.copy_into(tmp) && beta != data(0)) return false;
+		else if (!matrix<data>::gemm(alpha, matrix<data>(a), matrix<data>(b), beta, tmp, ta, tb, pol)) return false;
+
+		return tmp.copy_into(c);
+	}
+
+	const size_t m = ta ? a.m_cols : a.m_rows, k = ta ? a.m_rows : a.m_cols;
+	const size_t n = tb ? b.m_rows : b.m_cols;
+
+	if ((tb ? b.m_cols : b.m_rows) != k || m == 0 || n == 0) return false;
+	if (static_cast<const void*>(&c) == &a || static_cast<const void*>(&c) == &b) return false;
+
+	if (c.m_rows != m || c.m_cols != n)
+	{
+		if (beta != data(0) || !c.resize(m, n)) return false;
+	}
+	else c.detach();
+
+	MATRIX_PROFILE_SCOPE("gemm", m * n);
+
+	policy_scope scope(pol);
+
+	const auto strides = [] (const auto& mat, bool trans) -> std::pair<size_t, size_t>
+	{
+		using type = std::remove_cvref_t<decltype(mat)>;
+
+		const size_t rs = type::layout_type::col_order ? 1 : mat.m_cols;
+		const size_t cs = type::layout_type::col_order ? mat.m_rows : 1;
+
+		return trans ? std::make_pair(cs, rs) : std::make_pair(rs, cs);
+	};
+
+	const auto [ars, acs] = strides(a, ta);
+	const auto [brs, bcs] = strides(b, tb);
+	const auto [crs, ccs] = strides(c, false);
+
+	const size_t count = m * n;
+
+	parallel::run(m, c.get_threads(op::gemm, count, count * k), [&] (size_t lo, size_t hi)
+	{
+		for (size_t i = lo; i < hi; ++i)
+		{
+			data* row = c.m_ptr + i * crs;
+			const data* arow = a.m_ptr + i * ars;
+
+			if (bcs == 1)
+			{
+				for (size_t j = 0; j < n; ++j)
+				{
+					row[j * ccs] = beta == data(0) ? data(0) : beta * row[j * ccs];
+				}
+
+				for (size_t l = 0; l < k; ++l)
+				{
+					const data mul = alpha * arow[l * acs];
+					const data* brow = b.m_ptr + l * brs;
+
+					for (size_t j = 0; j < n; ++j) row[j * ccs] += mul * brow[j];
+				}
+			}
+			else for (size_t j = 0; j < n; ++j)
+			{
+				const data* bcol = b.m_ptr + j * bcs;
+				data sum = data(0);
+
+				for (size_t l = 0; l < k; ++l) sum += arow[l * acs] * bcol[l * brs];
+
+				row[j * ccs] = alpha * sum + (beta == data(0) ? data(0) : beta * row[j * ccs]);
+			}
+		}
+	});
+
+	return true;
 }
 
-template<typename data>
-matrix<data> matrix<data>::gen_diag(size_t size, const data& val)
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::gen_zeros(size_t rows, size_t cols)
 {
-	matrix<data> out(size, size, data(0));
+	return matrix<data, layout>(rows, cols, data(0));
+}
 
-	#pragma omp parallel for if (size > out.m_ompmin)
-	for (size_t i = 0; i < size; ++i) out.set_val(i, i, data(1));
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::gen_ones(size_t rows, size_t cols)
+{
+	return matrix<data, layout>(rows, cols, data(1));
+}
+
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::gen_diag(size_t size, const data& val)
+{
+	matrix<data, layout> out(size, size, data(0));
+
+	parallel::run(size, out.get_threads(op::fill, size), [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) out.set_val(i, i, data(1));
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> matrix<data>::gen_const(size_t rows, size_t cols, const data& val)
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::gen_const(size_t rows, size_t cols, const data& val)
 {
-	return matrix<data>(rows, cols, val);
+	return matrix<data, layout>(rows, cols, val);
 }
 
-template<typename data>
-matrix<data> matrix<data>::gen_linsp(size_t rows, size_t cols, const data& start, const data& stop)
+template<typename data, typename layout>
+matrix<data, layout> matrix<data, layout>::gen_linsp(size_t rows, size_t cols, const data& start, const data& stop)
 {
 	const size_t count = rows * cols;
 	const data dt = (stop - start);
-	matrix<data> out(rows, cols);
+	matrix<data, layout> out(rows, cols);
 
-	#pragma omp parallel for if (count > out.m_ompmin)
-	for (size_t i = 0; i < count; ++i)
+	parallel::run(count, out.get_threads(op::scalar, count), [&] (size_t b, size_t e)
 	{
-		out.m_ptr[i] = start + (dt * i) / (count - 1);
-	}
+		for (size_t i = b; i < e; ++i)
+		{
+			out.m_ptr[out.get_index(i)] = start + (dt * i) / (count - 1);
+		}
+	});
 
 	return out;
 }
 
-template<typename data>
-matrix<data> operator+ (const data& other, const matrix<data>& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator+ (const data& other, const matrix<data, layout>& mat)
 {
 	return mat + other;
 }
 
-template<typename data>
-matrix<data> operator+ (const data& other, matrix<data>&& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator+ (const data& other, matrix<data, layout>&& mat)
 {
 	return std::move(mat) + other;
 }
 
-template<typename data>
-matrix<data> operator- (const data& other, const matrix<data>& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator- (const data& other, const matrix<data, layout>& mat)
 {
 	return -mat + other;
 }
 
-template<typename data>
-matrix<data> operator- (const data& other, matrix<data>&& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator- (const data& other, matrix<data, layout>&& mat)
 {
 	return -std::move(mat) + other;
 }
 
-template<typename data>
-matrix<data> operator* (const data& other, const matrix<data>& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator* (const data& other, const matrix<data, layout>& mat)
 {
 	return mat * other;
 }
 
-template<typename data>
-matrix<data> operator* (const data& other, matrix<data>&& mat)
+template<typename data, typename layout>
+matrix<data, layout> operator* (const data& other, matrix<data, layout>&& mat)
 {
 	return std::move(mat) * other;
 }
@@ -21,15 +21,34 @@
 #ifndef MATRIX_HPP
 #define MATRIX_HPP
 
+#include <type_traits>
 #include <functional>
+#include <algorithm>
 #include <utility>
 #include <fstream>
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include <cstddef>
 #include <cmath>
 
-template<typename data = double>
+#ifndef MATRIX_INLINE_SIZE
+#define MATRIX_INLINE_SIZE 9
+#endif
+
+#ifndef MATRIX_TRANSPOSE_TILE
+#define MATRIX_TRANSPOSE_TILE 32
+#endif
+
+#include "layout.hpp"
+#include "resource.hpp"
+#include "tracker.hpp"
+#include "profile.hpp"
+#include "tuning.hpp"
+#include "strassen.hpp"
+
+template<typename data = double, typename layout = row_major>
 class matrix
 {
 
@@ -40,6 +59,7 @@ class matrix
 		using fun_type_c = std::function<data (data)>;
 
 		using data_type = data;
+		using layout_type = layout;
 
 	public: enum class mode
 		{
@@ -50,12 +70,48 @@ class matrix
 
 	protected:
 
+		using op = cost_model::op;
+
+		static constexpr size_t s_inline = MATRIX_INLINE_SIZE;
+		static constexpr size_t s_tile = MATRIX_TRANSPOSE_TILE;
+
+		static constexpr bool s_linear = std::is_same_v<layout, row_major> ||
+								   std::is_same_v<layout, col_major>;
+
 		data* m_ptr = nullptr;
+		matrix_resource* m_res = nullptr;
+
+#ifdef MATRIX_COW
+		using ref_type = std::atomic<size_t>;
+
+		static constexpr size_t s_align = std::max(alignof(data), alignof(ref_type));
+		static constexpr size_t s_head = (sizeof(ref_type) + alignof(data) - 1) / alignof(data) * alignof(data);
+
+		ref_type* m_refs = nullptr;
+#endif
 
 		size_t m_cols = 0;
 		size_t m_rows = 0;
 
-		size_t m_ompmin = 1024;
+		size_t m_ompmin = 0;
+
+		data m_local[s_inline ? s_inline : 1];
+
+		size_t get_threads(op o, size_t count, size_t work = 0) const;
+		size_t get_index(size_t i) const;
+
+		static void transpose_block(const data* src, data* dst, size_t rows, size_t cols,
+							   size_t rb, size_t re, size_t cb, size_t ce);
+
+		static void transpose_square(data* ptr, size_t size, size_t bi, size_t bj);
+		static void transpose_cycles(data* ptr, size_t rows, size_t cols);
+
+		template<typename type>
+		static data dot_kernel(const data* a, const type* b, size_t count);
+
+		template<typename type>
+		static void gemv_kernel(const data* a, size_t rs, size_t cs, const type* x,
+						    data* y, size_t rows, size_t cols, size_t tnum);
 
 	public:
 
@@ -71,24 +127,26 @@ class matrix
 
 		matrix(void) = default;
 
-		matrix(const matrix<data>& other);
-		matrix(matrix<data>&& other);
+		matrix(const matrix<data, layout>& other);
+		matrix(matrix<data, layout>&& other);
 
-		template<typename type>
-		matrix(const matrix<type>& other);
+		template<typename type, typename other_layout>
+		matrix(const matrix<type, other_layout>& other);
 
 		data& get_val(size_t row, size_t col);
 		const data& get_val(size_t row, size_t col) const;
 		const data& get_val(size_t row, size_t col, const data& def) const;
 		bool set_val(size_t row, size_t col, const data& val);
 
-		matrix<data> get_row(size_t n) const;
-		matrix<data> get_col(size_t n) const;
+		matrix<data, layout> get_row(size_t n) const;
+		matrix<data, layout> get_col(size_t n) const;
 
 		size_t rows(void) const;
 		size_t cols(void) const;
 		size_t size(void) const;
 
+		matrix_resource* get_resource(void) const;
+
 		size_t get_ompmin(void) const;
 		bool set_ompmin(size_t ompmin);
 
@@ -101,6 +159,10 @@ class matrix
 		bool is_valid(void) const;
 		bool is_vector(void) const;
 		bool is_square(void) const;
+		bool is_inline(void) const;
+		bool is_shared(void) const;
+
+		bool detach(void);
 
 		bool load(const std::string& path);
 		bool save(const std::string& path, std::streamsize prec = 6) const;
@@ -108,126 +170,167 @@ class matrix
 		bool load(std::istream& stream);
 		bool save(std::ostream& stream) const;
 
-		matrix<data> submatrix(size_t row, size_t col) const;
-		matrix<data> diagonal(mode mod = mode::rows) const;
-		matrix<data> transpose(void) const;
+		matrix<data, layout> submatrix(size_t row, size_t col) const;
+		matrix<data, layout> diagonal(mode mod = mode::rows) const;
+		matrix<data, layout> transpose(void) const&;
+		matrix<data, layout> transpose(void) &&;
+
+		bool transpose_inplace(void);
 
-		matrix<data> normalize(const data& val) const&;
-		matrix<data> normalize(const data& val) &&;
+		matrix<data, layout> normalize(const data& val) const&;
+		matrix<data, layout> normalize(const data& val) &&;
 
-		matrix<data> normalize(void) const&;
-		matrix<data> normalize(void) &&;
+		matrix<data, layout> normalize(void) const&;
+		matrix<data, layout> normalize(void) &&;
 
-		matrix<data> apply(const fun_type_a& fun, bool omp = true) const&;
-		matrix<data> apply(const fun_type_a& fun, bool omp = true) &&;
+		matrix<data, layout> apply(const fun_type_a& fun, const exec_policy& pol = exec_policy::automatic) const&;
+		matrix<data, layout> apply(const fun_type_a& fun, const exec_policy& pol = exec_policy::automatic) &&;
 
-		matrix<data> apply(const fun_type_b& fun, bool omp = true) const&;
-		matrix<data> apply(const fun_type_b& fun, bool omp = true) &&;
+		matrix<data, layout> apply(const fun_type_b& fun, const exec_policy& pol = exec_policy::automatic) const&;
+		matrix<data, layout> apply(const fun_type_b& fun, const exec_policy& pol = exec_policy::automatic) &&;
 
-		matrix<data> apply(const fun_type_c& fun, bool omp = true) const&;
-		matrix<data> apply(const fun_type_c& fun, bool omp = true) &&;
+		matrix<data, layout> apply(const fun_type_c& fun, const exec_policy& pol = exec_policy::automatic) const&;
+		matrix<data, layout> apply(const fun_type_c& fun, const exec_policy& pol = exec_policy::automatic) &&;
 
-		data mean(size_t n = 0, mode mod = mode::all) const;
-		data var(size_t n = 0, mode mod = mode::all) const;
-		data std(size_t n = 0, mode mod = mode::all) const;
+		data mean(size_t n = 0, mode mod = mode::all,
+				const exec_policy& pol = exec_policy::automatic) const;
+		data var(size_t n = 0, mode mod = mode::all,
+			    const exec_policy& pol = exec_policy::automatic) const;
+		data std(size_t n = 0, mode mod = mode::all,
+			    const exec_policy& pol = exec_policy::automatic) const;
 
 		data max(size_t n = 0, mode mod = mode::all) const;
 		data min(size_t n = 0, mode mod = mode::all) const;
 
-		data det(void) const;
+		data det(const exec_policy& pol = exec_policy::automatic) const;
 
 		template<typename type>
-		bool set_row(size_t n, const matrix<type>& other);
+		matrix<data, layout> add(const matrix<type, layout>& other, const exec_policy& pol) const;
 
 		template<typename type>
-		bool set_col(size_t n, const matrix<type>& other);
+		matrix<data, layout> sub(const matrix<type, layout>& other, const exec_policy& pol) const;
 
-		template<typename type>
-		matrix<data> operator+ (const matrix<type>& other) const&;
+		template<typename type, typename other_layout>
+		matrix<data, layout> mul(const matrix<type, other_layout>& other, const exec_policy& pol) const;
 
-		template<typename type>
-		matrix<data> operator- (const matrix<type>& other) const&;
+		matrix<data, layout> mul(const data& other, const exec_policy& pol) const;
+
+		template<typename type, typename other_layout>
+		data dot(const matrix<type, other_layout>& other) const;
+
+		template<typename type, typename other_layout>
+		matrix<data, layout> gemv(const matrix<type, other_layout>& other) const;
+
+		template<typename type, typename other_layout>
+		matrix<data, layout> outer(const matrix<type, other_layout>& other) const;
 
 		template<typename type>
-		matrix<data> operator+ (matrix<type>&& other) const;
+		bool axpy(const data& alpha, const matrix<type, layout>& x);
+
+		bool scal(const data& alpha);
+
+		template<typename other_layout>
+		bool copy_into(matrix<data, other_layout>& out) const;
 
 		template<typename type>
-		matrix<data> operator- (matrix<type>&& other) const;
+		bool set_row(size_t n, const matrix<type, layout>& other);
 
 		template<typename type>
-		matrix<data> operator+ (const matrix<type>& other) &&;
+		bool set_col(size_t n, const matrix<type, layout>& other);
 
 		template<typename type>
-		matrix<data> operator- (const matrix<type>& other) &&;
+		matrix<data, layout> operator+ (const matrix<type, layout>& other) const&;
 
 		template<typename type>
-		matrix<data> operator* (const matrix<type>& other) const;
+		matrix<data, layout> operator- (const matrix<type, layout>& other) const&;
 
 		template<typename type>
-		matrix<data> operator/ (const matrix<type>& other) const;
+		matrix<data, layout> operator+ (matrix<type, layout>&& other) const;
 
 		template<typename type>
-		matrix<data>& operator+= (const matrix<type>& other);
+		matrix<data, layout> operator- (matrix<type, layout>&& other) const;
 
 		template<typename type>
-		matrix<data>& operator-= (const matrix<type>& other);
+		matrix<data, layout> operator+ (const matrix<type, layout>& other) &&;
 
 		template<typename type>
-		matrix<data>& operator*= (const matrix<type>& other);
+		matrix<data, layout> operator- (const matrix<type, layout>& other) &&;
+
+		template<typename type, typename other_layout>
+		matrix<data, layout> operator* (const matrix<type, other_layout>& other) const;
 
 		template<typename type>
-		matrix<data>& operator/= (const matrix<type>& other);
+		matrix<data, layout> operator/ (const matrix<type, layout>& other) const;
 
 		template<typename type>
-		matrix<data>& operator+= (const type& other);
+		matrix<data, layout>& operator+= (const matrix<type, layout>& other);
 
 		template<typename type>
-		matrix<data>& operator-= (const type& other);
+		matrix<data, layout>& operator-= (const matrix<type, layout>& other);
+
+		template<typename type, typename other_layout>
+		matrix<data, layout>& operator*= (const matrix<type, other_layout>& other);
 
 		template<typename type>
-		matrix<data>& operator*= (const type& other);
+		matrix<data, layout>& operator/= (const matrix<type, layout>& other);
 
 		template<typename type>
-		matrix<data>& operator/= (const type& other);
+		matrix<data, layout>& operator+= (const type& other);
 
 		template<typename type>
-		matrix<data>& operator= (const matrix<type>& other);
+		matrix<data, layout>& operator-= (const type& other);
 
 		template<typename type>
-		bool operator== (const matrix<type>& other) const;
+		matrix<data, layout>& operator*= (const type& other);
 
 		template<typename type>
-		bool operator!= (const matrix<type>& other) const;
+		matrix<data, layout>& operator/= (const type& other);
 
-		matrix<data>& operator= (const matrix<data>& other);
-		matrix<data>& operator= (matrix<data>&& other);
+		template<typename type, typename other_layout>
+		matrix<data, layout>& operator= (const matrix<type, other_layout>& other);
 
-		matrix<data> operator+ (const data& other) const&;
-		matrix<data> operator- (const data& other) const&;
-		matrix<data> operator* (const data& other) const&;
-		matrix<data> operator/ (const data& other) const&;
+		template<typename type, typename other_layout>
+		bool operator== (const matrix<type, other_layout>& other) const;
 
-		matrix<data> operator+ (const data& other) &&;
-		matrix<data> operator- (const data& other) &&;
-		matrix<data> operator* (const data& other) &&;
-		matrix<data> operator/ (const data& other) &&;
+		template<typename type, typename other_layout>
+		bool operator!= (const matrix<type, other_layout>& other) const;
+
+		matrix<data, layout>& operator= (const matrix<data, layout>& other);
+		matrix<data, layout>& operator= (matrix<data, layout>&& other);
+
+		matrix<data, layout> operator+ (const data& other) const&;
+		matrix<data, layout> operator- (const data& other) const&;
+		matrix<data, layout> operator* (const data& other) const&;
+		matrix<data, layout> operator/ (const data& other) const&;
+
+		matrix<data, layout> operator+ (const data& other) &&;
+		matrix<data, layout> operator- (const data& other) &&;
+		matrix<data, layout> operator* (const data& other) &&;
+		matrix<data, layout> operator/ (const data& other) &&;
 
 		data& operator() (size_t row, size_t col);
 		const data& operator() (size_t row, size_t col) const;
 
-		matrix<data> operator- (void) const&;
-		matrix<data> operator- (void) &&;
+		matrix<data, layout> operator- (void) const&;
+		matrix<data, layout> operator- (void) &&;
+
+		template<typename, typename> friend class matrix;
+		template<typename> friend class matrix_batch;
+		template<typename> friend class symmetric_matrix;
 
-		template<typename type> friend class matrix;
+		~matrix(void);
 
-		virtual ~matrix(void);
+		template<typename layout_a, typename layout_b>
+		static bool gemm(const data& alpha, const matrix<data, layout_a>& a,
+					  const matrix<data, layout_b>& b, const data& beta, matrix<data, layout>& c,
+					  bool ta = false, bool tb = false, const exec_policy& pol = exec_policy::automatic);
 
-		static matrix<data> gen_zeros(size_t rows, size_t cols);
-		static matrix<data> gen_ones(size_t rows, size_t cols);
-		static matrix<data> gen_diag(size_t size, const data& val = data(1));
-		static matrix<data> gen_const(size_t rows, size_t cols,
+		static matrix<data, layout> gen_zeros(size_t rows, size_t cols);
+		static matrix<data, layout> gen_ones(size_t rows, size_t cols);
+		static matrix<data, layout> gen_diag(size_t size, const data& val = data(1));
+		static matrix<data, layout> gen_const(size_t rows, size_t cols,
 								const data& val);
-		static matrix<data> gen_linsp(size_t rows, size_t cols,
+		static matrix<data, layout> gen_linsp(size_t rows, size_t cols,
 								const data& start,
 								const data& stop);
 
@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <thread>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix<double> a(32, 32, 1.0), b(32, 32, 2.0);
+
+	if (a.get_resource() != &matrix_resource::heap()) endtest(n, ok);
+
+	pool_resource pool(4);
+
+	{
+		resource_scope scope(pool);
+
+		for (int i = 0; i < 10; ++i)
+		{
+			const auto c = a + b;
+
+			if (c(3, 4) != 3.0 || c.get_resource() != &pool) endtest(n, ok);
+		}
+	}
+
+	if (pool.misses() != 1 || pool.hits() != 9 || pool.cached() != 1) endtest(n, ok);
+
+	std::thread([&pool, &a]
+	{
+		resource_scope scope(pool);
+		const auto c = a * 2.0;
+	}).join();
+
+	if (pool.misses() != 2 || pool.cached() != 2) endtest(n, ok);
+
+	pool.trim();
+
+	if (pool.cached() != 0) endtest(n, ok);
+
+	{
+		arena_resource arena(4096);
+		resource_scope scope(arena);
+
+		matrix<double> c = a * b;
+		matrix<double> d = c.transpose();
+
+		if (c.get_resource() != &arena || d.get_resource() != &arena) endtest(n, ok);
+		if (arena.used() != 2 * 32 * 32 * sizeof(double) || arena.capacity() < arena.used()) endtest(n, ok);
+		if (c != a * b) endtest(n, ok);
+
+		matrix<double> e = std::move(c);
+
+		if (e.get_resource() != &arena || c.get_resource() != nullptr) endtest(n, ok);
+
+		d.clear();
+
+		if (arena.used() != 32 * 32 * sizeof(double)) endtest(n, ok);
+	}
+
+	auto& last = matrix_resource::set_default(pool);
+
+	{
+		matrix<int> f(8, 8, 1);
+
+		if (f.get_resource() != &pool || &last != &matrix_resource::heap()) endtest(n, ok);
+	}
+
+	matrix_resource::set_default(last);
+
+	if (matrix<int>(4, 4).get_resource() != &matrix_resource::heap()) endtest(n, ok);
+
+	{
+		alloc_tracker::guard guard(0, "inline");
+
+		matrix<double> s(3, 3, 1.0), t(1, 4, 2.0);
+		matrix<double> u = s * s;
+
+		u = s + s;
+		t = std::move(u);
+
+		if (!s.is_inline() || !t.is_inline() || u.is_valid()) endtest(n, ok);
+		if (s.get_resource() != nullptr || t(2, 2) != 2.0 || t.rows() != 3) endtest(n, ok);
+		if (!guard.is_ok()) endtest(n, ok);
+	}
+
+	{
+		matrix<double> s(3, 3);
+		const size_t count = alloc_tracker::thread_count();
+
+		s.resize(4, 4);
+
+		if (s.is_inline() || alloc_tracker::thread_count() != count + 1) endtest(n, ok);
+	}
+
+	return !(n == ok);
+}
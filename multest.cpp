@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include "matrix.hpp"
+#include "chain.hpp"
 
 int main(int argc, char* args[])
 {
@@ -53,5 +54,53 @@ int main(int argc, char* args[])
 	if (a * -1 != -a) endtest(n, ok);
 	if (b * -1 != -b) endtest(n, ok);
 
+	const matrix<int> u(1, 3, { 1, 2, 3 });
+	const matrix<int> v(3, 1, { 4, 5, 6 });
+	const matrix<int, col_major> gc = g;
+
+	const matrix<int> r4(3, 3, { 4, 8, 12, 5, 10, 15, 6, 12, 18 });
+	const matrix<int> r5(3, 1, { 32, 77, 122 });
+	const matrix<int> r6(1, 3, { 30, 36, 42 });
+
+	if (u * v != matrix<int>(1, 1, 32) || u.dot(v) != 32 || v.dot(u) != 32) endtest(n, ok);
+	if (v * u != r4 || v.outer(u) != r4 || v.outer(matrix<int, col_major>(u)) != r4) endtest(n, ok);
+	if (g * v != r5 || g.gemv(v.transpose()) != r5 || gc * v != matrix<int, col_major>(r5)) endtest(n, ok);
+	if (u * g != r6 || u * gc != r6 || u.dot(a) != 0 || g.gemv(a).is_valid()) endtest(n, ok);
+
+	matrix<double> x(1, 1000), y(1000, 1), m(37, 1000);
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		x(0, i) = double(i % 7); y(i, 0) = double(i % 5) - 2.0;
+
+		for (size_t j = 0; j < 37; ++j) m(j, i) = double((i + j) % 11);
+	}
+
+	x.set_ompmin(1); m.set_ompmin(1);
+
+	const auto mx = m * y;
+	const auto xm = x * m.transpose();
+
+	double sum = 0.0;
+
+	for (size_t i = 0; i < 1000; ++i) sum += x(0, i) * y(i, 0);
+
+	if (x.dot(y) != sum || (x * y)(0, 0) != sum) endtest(n, ok);
+	if (mx.rows() != 37 || mx(5, 0) != m.get_row(5).dot(y)) endtest(n, ok);
+	if (xm.cols() != 37 || xm(0, 9) != x.dot(m.get_row(9))) endtest(n, ok);
+
+	const matrix<int> hc = matrix_chain(a) * b * g;
+	auto ch = matrix_chain(a) * b * g;
+	matrix<int> t = a, o;
+
+	if (hc != r3 || !ch.eval(o) || !ch.eval(o) || o != r3 || ch.length() != 3) endtest(n, ok);
+	if (!(matrix_chain(t) * b * g).eval(t) || t != r3) endtest(n, ok);
+	if ((matrix_chain(b) * gc).eval() != b * g || (matrix_chain(a) * g).eval().is_valid()) endtest(n, ok);
+
+	auto mc = matrix_chain(m.transpose()) * m * y;
+
+	if (mc.cost() != 74000 || mc.naive_cost() != 38000000) endtest(n, ok);
+	if (mc.eval() != m.transpose() * mx || mc.rows() != 1000 || mc.cols() != 1) endtest(n, ok);
+
 	return !(n == ok);
 }
@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const size_t page = numa_resource::page_size();
+
+	numa_resource local(numa_resource::mode::first_touch, 16 * page);
+	numa_resource spread(numa_resource::mode::interleave, 16 * page);
+
+	matrix<double> a(128, 128), b(128, 128), s(4, 4, 1.0);
+
+	for (size_t i = 0; i < 128; ++i)
+		for (size_t j = 0; j < 128; ++j)
+		{
+			a(i, j) = double(i + j) / 7.0;
+			b(i, j) = double(i) - double(j);
+		}
+
+	const auto ref = a * b;
+
+	if (numa_resource::nodes() < 1 || page == 0) endtest(n, ok);
+
+	{
+		resource_scope scope(local);
+
+		matrix<double> c = a, d = b;
+		const auto e = c * d;
+
+		if (c.get_resource() != &local || local.mapped() < 3 * 128 * 128 * sizeof(double)) endtest(n, ok);
+		if (e != ref || reinterpret_cast<uintptr_t>(&c(0, 0)) % page) endtest(n, ok);
+
+		const int node = numa_resource::node_of(&c(127, 127));
+
+		if (node < -1 || node >= int(numa_resource::nodes())) endtest(n, ok);
+
+		const size_t used = local.mapped();
+		const matrix<double> t(2, 8, 1.0);
+
+		if (t.get_resource() != &local || local.mapped() != used || t.mean() != 1.0) endtest(n, ok);
+	}
+
+	if (local.mapped() != 0) endtest(n, ok);
+
+	{
+		resource_scope scope(spread);
+
+		matrix<double> c = a;
+		matrix<float, col_major> f = b;
+
+		c *= b;
+
+		if (c != ref || f(3, 5) != -2.0f || spread.mapped() == 0) endtest(n, ok);
+		if (spread.get_mode() != numa_resource::mode::interleave) endtest(n, ok);
+	}
+
+	if (spread.mapped() != 0 || !spread.set_mode(numa_resource::mode::local)) endtest(n, ok);
+
+	std::vector<char> buff(64 * page, 1);
+	numa_resource::first_touch(buff.data(), 64, page, 4);
+
+	if (std::count(buff.begin(), buff.end(), 1) != long(buff.size())) endtest(n, ok);
+
+	return !(n == ok);
+}
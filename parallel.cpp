@@ -0,0 +1,227 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARALLEL_CPP
+#define PARALLEL_CPP
+
+#ifndef PARALLEL_HPP
+#include "parallel.hpp"
+#endif
+
+inline thread_local const exec_policy* exec_policy::s_current = nullptr;
+
+inline const exec_policy exec_policy::automatic(exec_policy::kind::automatic);
+inline const exec_policy exec_policy::seq(exec_policy::kind::seq);
+inline const exec_policy exec_policy::par(exec_policy::kind::par);
+inline const exec_policy exec_policy::par_unseq(exec_policy::kind::par_unseq);
+
+inline exec_policy::exec_policy(kind knd, size_t threads)
+: m_kind(knd), m_threads(threads) {}
+
+inline exec_policy::exec_policy(executor exec, size_t threads)
+: m_kind(exec ? kind::custom : kind::automatic), m_threads(threads), m_exec(std::move(exec)) {}
+
+inline exec_policy::exec_policy(bool par)
+: m_kind(par ? kind::automatic : kind::seq) {}
+
+inline exec_policy::kind exec_policy::get_kind(void) const
+{
+	return m_kind;
+}
+
+inline size_t exec_policy::get_threads(void) const
+{
+	return m_threads;
+}
+
+inline const exec_policy::executor& exec_policy::get_executor(void) const
+{
+	return m_exec;
+}
+
+inline bool exec_policy::is_automatic(void) const
+{
+	return m_kind == kind::automatic;
+}
+
+inline const exec_policy& exec_policy::current(void)
+{
+	return s_current ? *s_current : automatic;
+}
+
+inline policy_scope::policy_scope(const exec_policy& pol)
+: m_last(exec_policy::s_current)
+{
+	if (!pol.is_automatic()) exec_policy::s_current = &pol;
+}
+
+inline policy_scope::~policy_scope(void)
+{
+	exec_policy::s_current = m_last;
+}
+
+#if defined(MATRIX_USE_POOL) || !defined(_OPENMP)
+inline std::atomic<parallel::backend> parallel::s_backend = parallel::backend::pool;
+#else
+inline std::atomic<parallel::backend> parallel::s_backend = parallel::backend::openmp;
+#endif
+
+inline parallel::backend parallel::get_backend(void)
+{
+	return s_backend.load(std::memory_order_relaxed);
+}
+
+inline bool parallel::set_backend(backend back)
+{
+	#ifndef _OPENMP
+	if (back == backend::openmp) return false;
+	#endif
+
+	s_backend.store(back, std::memory_order_relaxed);
+
+	return true;
+}
+
+inline size_t parallel::threads(void)
+{
+	const auto& pol = exec_policy::current();
+
+	if (pol.get_threads()) return pol.get_threads();
+	else switch (get_backend())
+	{
+	case backend::openmp:
+	#ifdef _OPENMP
+		return omp_get_max_threads();
+	#endif
+	case backend::pool:
+		return thread_pool::global().size();
+	case backend::stdpar:
+		return std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	return 1;
+}
+
+inline std::pair<size_t, size_t> parallel::chunk(size_t count, size_t tnum, size_t id)
+{
+	const size_t step = count / tnum, rest = count % tnum;
+	const size_t begin = id * step + std::min(id, rest);
+
+	return { begin, begin + step + (id < rest) };
+}
+
+template<typename fun>
+void parallel::spread(size_t tnum, const fun& g)
+{
+	if (const auto& pol = exec_policy::current(); pol.get_kind() == exec_policy::kind::custom)
+	{
+		return pol.get_executor()(tnum, tnum, [&g] (size_t b, size_t e)
+		{
+			for (size_t id = b; id < e; ++id) g(id);
+		});
+	}
+
+	switch (get_backend())
+	{
+	case backend::openmp:
+	#ifdef _OPENMP
+	{
+		if (omp_get_active_level() >= omp_get_max_active_levels())
+		{
+			for (size_t id = 0; id < tnum; ++id) g(id);
+		}
+		else
+		{
+			#pragma omp parallel for num_threads(tnum) schedule(static, 1)
+			for (size_t id = 0; id < tnum; ++id) g(id);
+		}
+	}
+	break;
+	#endif
+	case backend::pool:
+	{
+		thread_pool::global().parallel_for(0, tnum, 1, [&g] (size_t b, size_t e)
+		{
+			for (size_t id = b; id < e; ++id) g(id);
+		});
+	}
+	break;
+	case backend::stdpar:
+	{
+	#ifdef MATRIX_USE_STDPAR
+		std::vector<size_t> ids(tnum);
+		std::iota(ids.begin(), ids.end(), size_t(0));
+
+		std::for_each(std::execution::par, ids.begin(), ids.end(), g);
+	#else
+		std::vector<std::jthread> team;
+		team.reserve(tnum - 1);
+
+		for (size_t id = 1; id < tnum; ++id) team.emplace_back(g, id);
+
+		g(0);
+	#endif
+	}
+	break;
+	}
+}
+
+template<typename fun>
+void parallel::run(size_t count, size_t tnum, const fun& f)
+{
+	if (count == 0) return;
+	else if (tnum > count) tnum = count;
+
+	if (tnum <= 1) return f(0, count);
+
+	spread(tnum, [&] (size_t id)
+	{
+		const auto [begin, end] = chunk(count, tnum, id);
+
+		if (begin < end) f(begin, end);
+	});
+}
+
+template<typename type, typename fun, typename red>
+type parallel::reduce(size_t count, size_t tnum, const type& init,
+				  const fun& f, const red& r)
+{
+	if (count == 0) return init;
+	else if (tnum > count) tnum = count;
+
+	if (tnum <= 1) return r(init, f(0, count));
+
+	std::vector<type> part(tnum, init);
+
+	spread(tnum, [&] (size_t id)
+	{
+		const auto [begin, end] = chunk(count, tnum, id);
+
+		if (begin < end) part[id] = f(begin, end);
+	});
+
+	type out = init;
+
+	for (const auto& p : part) out = r(out, p);
+
+	return out;
+}
+
+#endif
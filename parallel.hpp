@@ -0,0 +1,153 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <atomic>
+#include <vector>
+
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef MATRIX_USE_STDPAR
+#include <execution>
+#endif
+
+#include <thread>
+
+#include "pool.hpp"
+
+class exec_policy
+{
+
+	public:
+
+		enum class kind
+		{
+			automatic,
+			seq,
+			par,
+			par_unseq,
+			custom
+		};
+
+		using range_type = std::function<void (size_t, size_t)>;
+		using executor = std::function<void (size_t, size_t, const range_type&)>;
+
+	protected:
+
+		kind m_kind = kind::automatic;
+		size_t m_threads = 0;
+
+		executor m_exec;
+
+		static thread_local const exec_policy* s_current;
+
+		friend class policy_scope;
+
+	public:
+
+		exec_policy(kind knd = kind::automatic, size_t threads = 0);
+		exec_policy(executor exec, size_t threads = 0);
+		exec_policy(bool par);
+
+		kind get_kind(void) const;
+		size_t get_threads(void) const;
+		const executor& get_executor(void) const;
+
+		bool is_automatic(void) const;
+
+		static const exec_policy& current(void);
+
+		static const exec_policy automatic;
+		static const exec_policy seq;
+		static const exec_policy par;
+		static const exec_policy par_unseq;
+
+};
+
+class policy_scope
+{
+
+	protected:
+
+		const exec_policy* m_last;
+
+	public:
+
+		explicit policy_scope(const exec_policy& pol);
+
+		policy_scope(const policy_scope&) = delete;
+		policy_scope& operator= (const policy_scope&) = delete;
+
+		~policy_scope(void);
+
+};
+
+class parallel
+{
+
+	public:
+
+		enum class backend
+		{
+			openmp,
+			pool,
+			stdpar
+		};
+
+	protected:
+
+		static std::atomic<backend> s_backend;
+
+		template<typename fun>
+		static void spread(size_t tnum, const fun& g);
+
+	public:
+
+		static backend get_backend(void);
+		static bool set_backend(backend back);
+
+		static size_t threads(void);
+
+		static std::pair<size_t, size_t> chunk(size_t count, size_t tnum, size_t id);
+
+		template<typename fun>
+		static void run(size_t count, size_t tnum, const fun& f);
+
+		template<typename type, typename fun, typename red>
+		static type reduce(size_t count, size_t tnum, const type& init,
+					    const fun& f, const red& r);
+
+};
+
+#ifndef PARALLEL_CPP
+#include "parallel.cpp"
+#endif
+
+#endif // PARALLEL_HPP
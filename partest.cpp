@@ -0,0 +1,129 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	thread_pool pool(3);
+
+	std::vector<int> hits(1000, 0);
+	std::atomic<int> nested = 0;
+
+	pool.parallel_for(0, hits.size(), 16, [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i) ++hits[i];
+	});
+
+	pool.parallel_for(0, 8, 1, [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+			pool.parallel_for(0, 100, 10, [&] (size_t b, size_t e)
+			{
+				nested += e - b;
+			});
+	});
+
+	const auto sum = pool.parallel_reduce(0, 1001, 7, 0, [] (size_t b, size_t e)
+	{
+		int s = 0; for (size_t i = b; i < e; ++i) s += i; return s;
+	}, std::plus<int>());
+
+	if (std::count(hits.begin(), hits.end(), 1) != 1000) endtest(n, ok);
+	if (nested != 800) endtest(n, ok);
+	if (sum != 500500) endtest(n, ok);
+
+	matrix<double> a(40, 40), b(40, 40);
+	matrix<int> d(6, 6);
+
+	a.set_ompmin(1); b.set_ompmin(1); d.set_ompmin(1);
+
+	for (size_t i = 0; i < 40; ++i)
+		for (size_t j = 0; j < 40; ++j)
+		{
+			a(i, j) = double(i * 7 + j * 3) / 11.0;
+			b(i, j) = double(i) - double(j) / 3.0;
+
+			if (i < 6 && j < 6) d(i, j) = (i == j) ? 3 : int(i + j) % 3;
+		}
+
+	parallel::set_backend(parallel::backend::openmp);
+
+	const auto c1 = a * b;
+	const auto t1 = a.transpose();
+	const auto m1 = a.mean();
+	const auto d1 = d.det();
+
+	parallel::set_backend(parallel::backend::pool);
+
+	const auto c2 = a * b;
+	const auto t2 = a.transpose();
+	const auto m2 = a.mean();
+	const auto d2 = d.det();
+
+	parallel::set_backend(parallel::backend::stdpar);
+
+	const auto c3 = a * b;
+	const auto m3 = a.mean();
+
+	parallel::set_backend(parallel::backend::pool);
+
+	size_t calls = 0;
+
+	const exec_policy custom([&calls] (size_t count, size_t, const exec_policy::range_type& f)
+	{
+		++calls; f(0, count);
+	}, 3);
+
+	const auto c4 = a.mul(b, custom);
+	const auto c5 = a.mul(b, exec_policy::seq);
+	const auto m4 = a.mean(0, decltype(a)::mode::all, exec_policy::par);
+
+	if (c1 != c2 || t1 != t2) endtest(n, ok);
+	if (c1 != c3 || c1 != c4 || c1 != c5) endtest(n, ok);
+	if (calls == 0 || exec_policy::current().get_kind() != exec_policy::kind::automatic) endtest(n, ok);
+	if (std::abs(m1 - m3) > 1e-9 || std::abs(m1 - m4) > 1e-9) endtest(n, ok);
+	if (std::abs(m1 - m2) > 1e-9) endtest(n, ok);
+	if (d1 != d2) endtest(n, ok);
+
+	cost_model model;
+
+	model.set_threads(4);
+
+	if (model.threads(cost_model::op::elementwise, 1024) != 1) endtest(n, ok);
+	if (model.threads(cost_model::op::gemm, 1 << 30) != 4) endtest(n, ok);
+	if (model.threads(cost_model::op::gemm, 1024 * 1024) <= 1) endtest(n, ok);
+
+	model.set_cost(cost_model::op::copy, 7.5);
+
+	cost_model other;
+
+	if (!model.save("tuning.txt") || !other.load("tuning.txt")) endtest(n, ok);
+	if (other.get_cost(cost_model::op::copy) != 7.5 || other.get_threads() != 4) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,255 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef POOL_CPP
+#define POOL_CPP
+
+#ifndef POOL_HPP
+#include "pool.hpp"
+#endif
+
+inline thread_local thread_pool* thread_pool::s_pool = nullptr;
+inline thread_local size_t thread_pool::s_index = 0;
+
+inline thread_pool::group::group(thread_pool& pool)
+: m_pool(pool) {}
+
+inline void thread_pool::group::run(task_type task)
+{
+	m_count.fetch_add(1, std::memory_order_relaxed);
+
+	m_pool.submit([this, task = std::move(task)] (void)
+	{
+		task(); m_count.fetch_sub(1, std::memory_order_release);
+	});
+}
+
+inline void thread_pool::group::wait(void)
+{
+	while (m_count.load(std::memory_order_acquire))
+		if (!m_pool.run_one()) std::this_thread::yield();
+}
+
+inline thread_pool::group::~group(void)
+{
+	wait();
+}
+
+inline thread_pool::thread_pool(size_t threads)
+{
+	if (threads == 0)
+	{
+		const size_t hw = std::thread::hardware_concurrency();
+		threads = hw > 1 ? hw - 1 : 0;
+	}
+
+	for (size_t i = 0; i <= threads; ++i)
+		m_queues.push_back(std::make_unique<queue>());
+
+	for (size_t i = 1; i <= threads; ++i)
+		m_threads.emplace_back(&thread_pool::worker, this, i);
+}
+
+inline bool thread_pool::pop(size_t index, task_type& task)
+{
+	auto& q = *m_queues[index];
+	std::lock_guard<std::mutex> lock(q.mutex);
+
+	if (q.tasks.empty()) return false;
+
+	task = std::move(q.tasks.back());
+	q.tasks.pop_back();
+
+	return true;
+}
+
+inline bool thread_pool::steal(size_t index, task_type& task)
+{
+	const size_t count = m_queues.size();
+
+	for (size_t i = 1; i <= count; ++i)
+	{
+		auto& q = *m_queues[(index + i) % count];
+		std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+
+		if (!lock.owns_lock() || q.tasks.empty()) continue;
+
+		task = std::move(q.tasks.front());
+		q.tasks.pop_front();
+
+		return true;
+	}
+
+	return false;
+}
+
+inline void thread_pool::worker(size_t index)
+{
+	s_pool = this;
+	s_index = index;
+
+	while (true)
+	{
+		if (run_one()) continue;
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_cond.wait(lock, [this] (void)
+		{
+			return m_stop || m_pending.load(std::memory_order_acquire);
+		});
+
+		if (m_stop && !m_pending.load(std::memory_order_acquire)) break;
+	}
+
+	s_pool = nullptr;
+}
+
+inline void thread_pool::submit(task_type task)
+{
+	const size_t index = s_pool == this ? s_index :
+		m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+	{
+		auto& q = *m_queues[index];
+		std::lock_guard<std::mutex> lock(q.mutex);
+
+		q.tasks.push_back(std::move(task));
+	}
+
+	m_pending.fetch_add(1, std::memory_order_release);
+
+	if (!m_threads.empty())
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_cond.notify_one();
+	}
+}
+
+inline bool thread_pool::run_one(void)
+{
+	const size_t index = s_pool == this ? s_index : 0;
+	task_type task;
+
+	if (!pop(index, task) && !steal(index, task)) return false;
+
+	m_pending.fetch_sub(1, std::memory_order_acq_rel);
+	task();
+
+	return true;
+}
+
+template<typename fun>
+void thread_pool::split(group& grp, size_t begin, size_t end,
+				    size_t grain, const fun& f)
+{
+	while (end - begin > grain)
+	{
+		const size_t mid = begin + (end - begin) / 2;
+
+		grp.run([&grp, mid, end, grain, &f] (void)
+		{
+			split(grp, mid, end, grain, f);
+		});
+
+		end = mid;
+	}
+
+	f(begin, end);
+}
+
+template<typename fun>
+void thread_pool::parallel_for(size_t begin, size_t end, size_t grain, const fun& f)
+{
+	if (end <= begin) return;
+	else if (grain == 0) grain = 1;
+
+	if (m_threads.empty() || end - begin <= grain) return f(begin, end);
+
+	group grp(*this);
+
+	split(grp, begin, end, grain, f);
+	grp.wait();
+}
+
+template<typename type, typename fun, typename red>
+type thread_pool::parallel_reduce(size_t begin, size_t end, size_t grain,
+						    const type& init, const fun& f, const red& r)
+{
+	if (end <= begin) return init;
+	else if (grain == 0) grain = 1;
+
+	const size_t count = (end - begin + grain - 1) / grain;
+	std::vector<type> part(count, init);
+
+	parallel_for(0, count, 1, [&] (size_t b, size_t e)
+	{
+		for (size_t i = b; i < e; ++i)
+		{
+			const size_t first = begin + i * grain;
+			const size_t last = std::min(first + grain, end);
+
+			part[i] = f(first, last);
+		}
+	});
+
+	type out = init;
+
+	for (const auto& p : part) out = r(out, p);
+
+	return out;
+}
+
+inline size_t thread_pool::size(void) const
+{
+	return m_threads.size() + 1;
+}
+
+inline bool thread_pool::is_worker(void) const
+{
+	return s_pool == this;
+}
+
+inline thread_pool::~thread_pool(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_cond.notify_all();
+
+	for (auto& t : m_threads) t.join();
+}
+
+inline thread_pool& thread_pool::global(void)
+{
+	static thread_pool pool([] (void) -> size_t
+	{
+		const char* env = std::getenv("MATRIX_THREADS");
+		const long num = env ? std::atol(env) : 0;
+
+		return num > 1 ? num - 1 : 0;
+	}());
+
+	return pool;
+}
+
+#endif
@@ -0,0 +1,127 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <deque>
+
+#include <cstddef>
+#include <cstdlib>
+
+class thread_pool
+{
+
+	public:
+
+		using task_type = std::function<void (void)>;
+
+		class group
+		{
+
+			protected:
+
+				thread_pool& m_pool;
+				std::atomic<size_t> m_count = 0;
+
+			public:
+
+				explicit group(thread_pool& pool);
+
+				group(const group&) = delete;
+				group& operator= (const group&) = delete;
+
+				void run(task_type task);
+				void wait(void);
+
+				~group(void);
+
+		};
+
+	protected:
+
+		struct queue
+		{
+			std::deque<task_type> tasks;
+			std::mutex mutex;
+		};
+
+		std::vector<std::unique_ptr<queue>> m_queues;
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_mutex;
+		std::condition_variable m_cond;
+
+		std::atomic<size_t> m_pending = 0;
+		std::atomic<size_t> m_next = 0;
+
+		bool m_stop = false;
+
+		static thread_local thread_pool* s_pool;
+		static thread_local size_t s_index;
+
+		bool pop(size_t index, task_type& task);
+		bool steal(size_t index, task_type& task);
+
+		void worker(size_t index);
+
+		template<typename fun>
+		static void split(group& grp, size_t begin, size_t end,
+					   size_t grain, const fun& f);
+
+	public:
+
+		explicit thread_pool(size_t threads = 0);
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator= (const thread_pool&) = delete;
+
+		void submit(task_type task);
+		bool run_one(void);
+
+		template<typename fun>
+		void parallel_for(size_t begin, size_t end, size_t grain, const fun& f);
+
+		template<typename type, typename fun, typename red>
+		type parallel_reduce(size_t begin, size_t end, size_t grain,
+						 const type& init, const fun& f, const red& r);
+
+		size_t size(void) const;
+		bool is_worker(void) const;
+
+		~thread_pool(void);
+
+		static thread_pool& global(void);
+
+};
+
+#ifndef POOL_CPP
+#include "pool.cpp"
+#endif
+
+#endif // POOL_HPP
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <thread>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix<double> a(20, 30, 1.0), b(30, 20, 2.0);
+
+	profiler::global().clear();
+
+	for (int i = 0; i < 3; ++i) a.transpose();
+	for (int i = 0; i < 5; ++i) a.get_row(i);
+
+	const auto c = a * b;
+
+	std::thread([&a] { a.get_col(0); }).join();
+
+	const auto stats = profiler::global().summary();
+	const auto threads = profiler::global().per_thread();
+
+	if (!stats.count("transpose") || !stats.count("get_row") || !stats.count("gemm")) endtest(n, ok);
+	if (stats.at("transpose").calls != 3 || stats.at("transpose").elements != 3 * 600) endtest(n, ok);
+	if (stats.at("transpose").bytes != 3 * 600 * sizeof(double)) endtest(n, ok);
+	if (stats.at("get_row").calls != 5 || stats.at("gemm").calls != 1) endtest(n, ok);
+	if (stats.at("gemm").time <= 0.0) endtest(n, ok);
+
+	if (std::count_if(threads.begin(), threads.end(), [] (const auto& r)
+	{
+		return r.first.first == "get_col";
+	}) != 1) endtest(n, ok);
+
+	if (threads.size() <= stats.size() - 1) endtest(n, ok);
+
+	std::stringstream table;
+
+	if (!profiler::global().print(table) || table.str().find("transpose") == std::string::npos) endtest(n, ok);
+	if (!profiler::global().save_trace("trace.json")) endtest(n, ok);
+
+	std::ifstream trace("trace.json");
+	const std::string json((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+
+	if (json.find("\"traceEvents\"") == std::string::npos || json.find("\"ph\": \"X\"") == std::string::npos) endtest(n, ok);
+	if (profiler::global().events() < 10) endtest(n, ok);
+
+	profiler::global().set_enabled(false);
+	a.transpose();
+	profiler::global().set_enabled(true);
+
+	if (profiler::global().summary().at("transpose").calls != 3) endtest(n, ok);
+
+	profiler::global().clear();
+
+	if (!profiler::global().summary().empty() || profiler::global().events() != 0) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,251 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PROFILE_CPP
+#define PROFILE_CPP
+
+#ifndef PROFILE_HPP
+#include "profile.hpp"
+#endif
+
+inline profiler::scope::scope(const char* name, size_t elements)
+: m_name(name), m_elements(elements), m_bytes(alloc_tracker::thread_bytes()),
+  m_start(clock::now()), m_site(name) {}
+
+inline profiler::scope::~scope(void)
+{
+	profiler::global().add(m_name, m_elements, alloc_tracker::thread_bytes() - m_bytes, m_start, clock::now());
+}
+
+inline profiler::profiler(void)
+: m_epoch(clock::now()) {}
+
+inline profiler::local& profiler::get_local(void)
+{
+	thread_local std::vector<std::pair<const profiler*, std::shared_ptr<local>>> cache;
+
+	for (const auto& [owner, loc] : cache)
+		if (owner == this) return *loc;
+
+	auto loc = std::make_shared<local>();
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		loc->id = m_locals.size();
+		m_locals.push_back(loc);
+	}
+
+	cache.emplace_back(this, loc);
+
+	return *loc;
+}
+
+inline void profiler::add(const char* name, size_t elements, size_t bytes,
+					 clock::time_point start, clock::time_point stop)
+{
+	if (!m_enabled.load(std::memory_order_relaxed)) return;
+
+	using sec = std::chrono::duration<double>;
+
+	auto& loc = get_local();
+	const double time = sec(stop - start).count();
+
+	std::lock_guard<std::mutex> lock(loc.lock);
+
+	auto& rec = loc.stats[name];
+
+	rec.calls += 1;
+	rec.elements += elements;
+	rec.bytes += bytes;
+	rec.time += time;
+
+	if (m_tracing.load(std::memory_order_relaxed) &&
+	    loc.events.size() < m_limit.load(std::memory_order_relaxed))
+	{
+		loc.events.push_back({ name, elements, bytes, sec(start - m_epoch).count(), time });
+	}
+}
+
+inline std::map<std::string, profiler::record> profiler::summary(void) const
+{
+	std::map<std::string, record> out;
+
+	for (const auto& [key, rec] : per_thread())
+	{
+		auto& sum = out[key.first];
+
+		sum.calls += rec.calls;
+		sum.elements += rec.elements;
+		sum.bytes += rec.bytes;
+		sum.time += rec.time;
+	}
+
+	return out;
+}
+
+inline std::map<std::pair<std::string, size_t>, profiler::record> profiler::per_thread(void) const
+{
+	std::map<std::pair<std::string, size_t>, record> out;
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (const auto& loc : m_locals)
+	{
+		std::lock_guard<std::mutex> guard(loc->lock);
+
+		for (const auto& [name, rec] : loc->stats)
+		{
+			auto& sum = out[{ name, loc->id }];
+
+			sum.calls += rec.calls;
+			sum.elements += rec.elements;
+			sum.bytes += rec.bytes;
+			sum.time += rec.time;
+		}
+	}
+
+	return out;
+}
+
+inline size_t profiler::events(void) const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	size_t count = 0;
+
+	for (const auto& loc : m_locals)
+	{
+		std::lock_guard<std::mutex> guard(loc->lock);
+		count += loc->events.size();
+	}
+
+	return count;
+}
+
+inline bool profiler::is_enabled(void) const
+{
+	return m_enabled.load(std::memory_order_relaxed);
+}
+
+inline bool profiler::set_enabled(bool enabled)
+{
+	m_enabled.store(enabled, std::memory_order_relaxed); return true;
+}
+
+inline bool profiler::is_tracing(void) const
+{
+	return m_tracing.load(std::memory_order_relaxed);
+}
+
+inline bool profiler::set_tracing(bool tracing)
+{
+	m_tracing.store(tracing, std::memory_order_relaxed); return true;
+}
+
+inline size_t profiler::get_limit(void) const
+{
+	return m_limit.load(std::memory_order_relaxed);
+}
+
+inline bool profiler::set_limit(size_t limit)
+{
+	m_limit.store(limit, std::memory_order_relaxed); return true;
+}
+
+inline void profiler::clear(void)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (const auto& loc : m_locals)
+	{
+		std::lock_guard<std::mutex> guard(loc->lock);
+
+		loc->stats.clear();
+		loc->events.clear();
+	}
+}
+
+inline bool profiler::print(std::ostream& stream) const
+{
+	const auto stats = summary();
+
+	std::vector<std::pair<std::string, record>> list(stats.begin(), stats.end());
+
+	std::sort(list.begin(), list.end(), [] (const auto& a, const auto& b)
+	{
+		return a.second.time > b.second.time;
+	});
+
+	stream << std::left << std::setw(16) << "operation" << std::right
+		  << std::setw(10) << "calls" << std::setw(14) << "elements"
+		  << std::setw(14) << "bytes" << std::setw(12) << "time[ms]"
+		  << std::setw(12) << "avg[us]" << std::endl;
+
+	for (const auto& [name, rec] : list)
+	{
+		stream << std::left << std::setw(16) << name << std::right
+			  << std::setw(10) << rec.calls << std::setw(14) << rec.elements
+			  << std::setw(14) << rec.bytes << std::fixed << std::setprecision(3)
+			  << std::setw(12) << rec.time * 1e3
+			  << std::setw(12) << rec.time * 1e6 / rec.calls
+			  << std::defaultfloat << std::endl;
+	}
+
+	return !stream.fail();
+}
+
+inline bool profiler::save_trace(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	std::lock_guard<std::mutex> lock(m_lock);
+	bool first = true;
+
+	file << "{\"traceEvents\": [\n";
+	file << std::fixed << std::setprecision(3);
+
+	for (const auto& loc : m_locals)
+	{
+		std::lock_guard<std::mutex> guard(loc->lock);
+
+		for (const auto& e : loc->events)
+		{
+			file << (first ? "  " : ",\n  ")
+				<< "{\"name\": \"" << e.name << "\", \"cat\": \"matrix\", \"ph\": \"X\""
+				<< ", \"ts\": " << e.start * 1e6 << ", \"dur\": " << e.time * 1e6
+				<< ", \"pid\": 1, \"tid\": " << loc->id
+				<< ", \"args\": {\"elements\": " << e.elements
+				<< ", \"bytes\": " << e.bytes << "}}";
+
+			first = false;
+		}
+	}
+
+	file << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+	return !file.fail();
+}
+
+inline profiler& profiler::global(void)
+{
+	static profiler prof; return prof;
+}
+
+#endif
@@ -0,0 +1,157 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <utility>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <map>
+
+#include <cstddef>
+
+#include "tracker.hpp"
+
+#ifdef MATRIX_PROFILE
+#define MATRIX_PROFILE_SCOPE(name, elements) profiler::scope matrix_profile_scope(name, elements)
+#else
+#define MATRIX_PROFILE_SCOPE(name, elements) ((void) 0)
+#endif
+
+class profiler
+{
+
+	public:
+
+		using clock = std::chrono::steady_clock;
+
+		struct record
+		{
+			size_t calls = 0;
+			size_t elements = 0;
+			size_t bytes = 0;
+
+			double time = 0.0;
+		};
+
+		struct event
+		{
+			const char* name;
+
+			size_t elements;
+			size_t bytes;
+
+			double start;
+			double time;
+		};
+
+		class scope
+		{
+
+			protected:
+
+				const char* m_name;
+				size_t m_elements;
+				size_t m_bytes;
+
+				clock::time_point m_start;
+				alloc_tracker::site m_site;
+
+			public:
+
+				scope(const char* name, size_t elements);
+				~scope(void);
+
+				scope(const scope&) = delete;
+				scope& operator= (const scope&) = delete;
+
+		};
+
+	protected:
+
+		struct local
+		{
+			std::mutex lock;
+
+			std::unordered_map<const char*, record> stats;
+			std::vector<event> events;
+
+			size_t id = 0;
+		};
+
+		mutable std::mutex m_lock;
+		std::vector<std::shared_ptr<local>> m_locals;
+
+		clock::time_point m_epoch;
+
+		std::atomic<bool> m_enabled = true;
+		std::atomic<bool> m_tracing = true;
+		std::atomic<size_t> m_limit = 1 << 20;
+
+		local& get_local(void);
+
+	public:
+
+		profiler(void);
+
+		profiler(const profiler&) = delete;
+		profiler& operator= (const profiler&) = delete;
+
+		void add(const char* name, size_t elements, size_t bytes,
+			    clock::time_point start, clock::time_point stop);
+
+		std::map<std::string, record> summary(void) const;
+		std::map<std::pair<std::string, size_t>, record> per_thread(void) const;
+
+		size_t events(void) const;
+
+		bool is_enabled(void) const;
+		bool set_enabled(bool enabled);
+
+		bool is_tracing(void) const;
+		bool set_tracing(bool tracing);
+
+		size_t get_limit(void) const;
+		bool set_limit(size_t limit);
+
+		void clear(void);
+
+		bool print(std::ostream& stream) const;
+		bool save_trace(const std::string& path) const;
+
+		static profiler& global(void);
+
+};
+
+#ifndef PROFILE_CPP
+#include "profile.cpp"
+#endif
+
+#endif // PROFILE_HPP
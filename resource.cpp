@@ -0,0 +1,726 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RESOURCE_CPP
+#define RESOURCE_CPP
+
+#ifndef RESOURCE_HPP
+#include "resource.hpp"
+#endif
+
+inline thread_local matrix_resource* matrix_resource::s_current = nullptr;
+inline std::atomic<matrix_resource*> matrix_resource::s_default = nullptr;
+
+inline matrix_resource& matrix_resource::current(void)
+{
+	return s_current ? *s_current : get_default();
+}
+
+inline matrix_resource& matrix_resource::get_default(void)
+{
+	static const bool init = []
+	{
+		const char* env = std::getenv("MATRIX_ALLOCATOR");
+
+		matrix_resource* none = nullptr;
+
+		if (env && std::strcmp(env, "pool") == 0)
+		{
+			s_default.compare_exchange_strong(none, &pool_resource::global());
+		}
+		else if (env && std::strcmp(env, "numa") == 0)
+		{
+			s_default.compare_exchange_strong(none, &numa_resource::global());
+		}
+		else if (env && std::strcmp(env, "huge") == 0)
+		{
+			s_default.compare_exchange_strong(none, &huge_resource::global());
+		}
+		else if (env && std::strcmp(env, "interleave") == 0)
+		{
+			numa_resource::global().set_mode(numa_resource::mode::interleave);
+			s_default.compare_exchange_strong(none, &numa_resource::global());
+		}
+
+		return true;
+	}();
+
+	(void) init;
+
+	if (auto res = s_default.load(std::memory_order_acquire)) return *res;
+	else return heap();
+}
+
+inline matrix_resource& matrix_resource::set_default(matrix_resource& res)
+{
+	get_default();
+
+	auto last = s_default.exchange(&res, std::memory_order_acq_rel);
+
+	return last ? *last : heap();
+}
+
+inline void matrix_resource::touch(void*, size_t, size_t) {}
+
+inline matrix_resource& matrix_resource::heap(void)
+{
+	static heap_resource res; return res;
+}
+
+inline resource_scope::resource_scope(matrix_resource& res)
+: m_last(matrix_resource::s_current)
+{
+	matrix_resource::s_current = &res;
+}
+
+inline resource_scope::~resource_scope(void)
+{
+	matrix_resource::s_current = m_last;
+}
+
+inline void* heap_resource::allocate(size_t bytes, size_t align)
+{
+	if (align <= alignof(std::max_align_t)) return std::malloc(bytes);
+	else return std::aligned_alloc(align, (bytes + align - 1) / align * align);
+}
+
+inline void heap_resource::deallocate(void* ptr, size_t, size_t)
+{
+	std::free(ptr);
+}
+
+inline pool_resource::pool_resource(size_t keep, matrix_resource& upstream)
+: m_upstream(upstream), m_keep(keep) {}
+
+inline pool_resource::~pool_resource(void)
+{
+	trim();
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (const auto& c : m_caches)
+	{
+		std::lock_guard<std::mutex> guard(c->lock);
+		c->alive = false;
+	}
+}
+
+inline pool_resource::cache& pool_resource::get_cache(void)
+{
+	thread_local std::vector<std::pair<const pool_resource*, std::shared_ptr<cache>>> list;
+
+	for (auto& [owner, c] : list)
+		if (owner == this)
+		{
+			if (c->alive) return *c;
+			else owner = nullptr;
+		}
+
+	auto c = std::make_shared<cache>();
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_caches.push_back(c);
+	}
+
+	list.emplace_back(this, c);
+
+	return *c;
+}
+
+inline size_t pool_resource::get_class(size_t bytes)
+{
+	size_t cls = 0;
+
+	while (get_size(cls) < bytes && cls < s_classes) ++cls;
+
+	return cls;
+}
+
+inline size_t pool_resource::get_size(size_t cls)
+{
+	return size_t(1) << (cls + s_minshift);
+}
+
+inline void* pool_resource::allocate(size_t bytes, size_t align)
+{
+	const size_t cls = get_class(bytes);
+
+	if (cls >= s_classes || align > get_size(0))
+	{
+		return m_upstream.allocate(bytes, align);
+	}
+
+	auto& c = get_cache();
+
+	{
+		std::lock_guard<std::mutex> lock(c.lock);
+		auto& list = c.lists[cls];
+
+		if (!list.empty())
+		{
+			void* ptr = list.back();
+			list.pop_back();
+
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+
+			return ptr;
+		}
+	}
+
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+
+	return m_upstream.allocate(get_size(cls), std::max(align, get_size(0)));
+}
+
+inline void pool_resource::deallocate(void* ptr, size_t bytes, size_t align)
+{
+	const size_t cls = get_class(bytes);
+
+	if (cls >= s_classes || align > get_size(0))
+	{
+		return m_upstream.deallocate(ptr, bytes, align);
+	}
+
+	auto& c = get_cache();
+
+	{
+		std::lock_guard<std::mutex> lock(c.lock);
+		auto& list = c.lists[cls];
+
+		if (list.size() < m_keep.load(std::memory_order_relaxed))
+		{
+			return list.push_back(ptr);
+		}
+	}
+
+	m_upstream.deallocate(ptr, get_size(cls), std::max(align, get_size(0)));
+}
+
+inline size_t pool_resource::get_keep(void) const
+{
+	return m_keep.load(std::memory_order_relaxed);
+}
+
+inline bool pool_resource::set_keep(size_t keep)
+{
+	m_keep.store(keep, std::memory_order_relaxed); return true;
+}
+
+inline size_t pool_resource::hits(void) const
+{
+	return m_hits.load(std::memory_order_relaxed);
+}
+
+inline size_t pool_resource::misses(void) const
+{
+	return m_misses.load(std::memory_order_relaxed);
+}
+
+inline size_t pool_resource::cached(void) const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	size_t count = 0;
+
+	for (const auto& c : m_caches)
+	{
+		std::lock_guard<std::mutex> guard(c->lock);
+
+		for (const auto& list : c->lists) count += list.size();
+	}
+
+	return count;
+}
+
+inline void pool_resource::trim(void)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (const auto& c : m_caches)
+	{
+		std::lock_guard<std::mutex> guard(c->lock);
+
+		for (size_t cls = 0; cls < s_classes; ++cls)
+		{
+			for (const auto& ptr : c->lists[cls])
+				m_upstream.deallocate(ptr, get_size(cls), get_size(0));
+
+			c->lists[cls].clear();
+		}
+	}
+}
+
+inline pool_resource& pool_resource::global(void)
+{
+	static pool_resource res; return res;
+}
+
+inline arena_resource::arena_resource(size_t chunk, matrix_resource& upstream)
+: m_upstream(upstream), m_chunk(std::max<size_t>(chunk, 64)) {}
+
+inline arena_resource::~arena_resource(void)
+{
+	release();
+}
+
+inline void* arena_resource::allocate(size_t bytes, size_t align)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	if (!m_chunks.empty())
+	{
+		const auto& last = m_chunks.back();
+		const auto base = reinterpret_cast<uintptr_t>(last.ptr);
+		const size_t start = (base + m_offset + align - 1) / align * align - base;
+
+		if (start + bytes <= last.size)
+		{
+			m_offset = start + bytes;
+			m_used += bytes;
+
+			return last.ptr + start;
+		}
+	}
+
+	const size_t size = std::max(m_chunk, bytes + align);
+	void* mem = m_upstream.allocate(size, alignof(std::max_align_t));
+
+	if (!mem) return nullptr;
+
+	m_chunks.push_back({ static_cast<char*>(mem), size });
+
+	const auto base = reinterpret_cast<uintptr_t>(mem);
+	const size_t start = (base + align - 1) / align * align - base;
+
+	m_offset = start + bytes;
+	m_used += bytes;
+
+	return static_cast<char*>(mem) + start;
+}
+
+inline void arena_resource::deallocate(void* ptr, size_t bytes, size_t)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	if (m_chunks.empty()) return;
+	else m_used -= std::min(m_used, bytes);
+
+	const auto& last = m_chunks.back();
+
+	if (static_cast<char*>(ptr) + bytes == last.ptr + m_offset)
+	{
+		m_offset = static_cast<char*>(ptr) - last.ptr;
+	}
+}
+
+inline size_t arena_resource::used(void) const
+{
+	std::lock_guard<std::mutex> lock(m_lock); return m_used;
+}
+
+inline size_t arena_resource::capacity(void) const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	size_t size = 0;
+
+	for (const auto& c : m_chunks) size += c.size;
+
+	return size;
+}
+
+inline void arena_resource::release(void)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	for (const auto& c : m_chunks)
+		m_upstream.deallocate(c.ptr, c.size, alignof(std::max_align_t));
+
+	m_chunks.clear();
+	m_offset = m_used = 0;
+}
+
+inline numa_resource::numa_resource(mode mod, size_t threshold, matrix_resource& upstream)
+: m_upstream(upstream), m_mode(mod), m_threshold(std::max(threshold, page_size())) {}
+
+inline size_t numa_resource::get_length(size_t bytes)
+{
+	const size_t page = page_size();
+
+	return (bytes + page - 1) / page * page;
+}
+
+inline void* numa_resource::allocate(size_t bytes, size_t align)
+{
+	#ifdef __linux__
+	if (bytes >= m_threshold && align <= page_size())
+	{
+		const size_t len = get_length(bytes);
+		void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+					  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (ptr == MAP_FAILED) return nullptr;
+		else m_mapped.fetch_add(len, std::memory_order_relaxed);
+
+		if (get_mode() == mode::interleave && !interleave(ptr, len))
+		{
+			m_failed.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		return ptr;
+	}
+	#endif
+
+	return m_upstream.allocate(bytes, align);
+}
+
+inline void numa_resource::deallocate(void* ptr, size_t bytes, size_t align)
+{
+	#ifdef __linux__
+	if (bytes >= m_threshold && align <= page_size())
+	{
+		const size_t len = get_length(bytes);
+
+		munmap(ptr, len);
+		m_mapped.fetch_sub(len, std::memory_order_relaxed);
+
+		return;
+	}
+	#endif
+
+	m_upstream.deallocate(ptr, bytes, align);
+}
+
+inline void numa_resource::touch(void* ptr, size_t rows, size_t stride)
+{
+	if (rows * stride >= m_threshold && get_mode() == mode::first_touch)
+	{
+		first_touch(ptr, rows, stride);
+	}
+}
+
+inline numa_resource::mode numa_resource::get_mode(void) const
+{
+	return m_mode.load(std::memory_order_relaxed);
+}
+
+inline bool numa_resource::set_mode(mode mod)
+{
+	m_mode.store(mod, std::memory_order_relaxed); return true;
+}
+
+inline size_t numa_resource::get_threshold(void) const
+{
+	return m_threshold;
+}
+
+inline size_t numa_resource::mapped(void) const
+{
+	return m_mapped.load(std::memory_order_relaxed);
+}
+
+inline size_t numa_resource::failed(void) const
+{
+	return m_failed.load(std::memory_order_relaxed);
+}
+
+inline size_t numa_resource::page_size(void)
+{
+	#ifdef __linux__
+	static const size_t size = sysconf(_SC_PAGESIZE);
+	#else
+	static const size_t size = 4096;
+	#endif
+
+	return size;
+}
+
+inline size_t numa_resource::nodes(void)
+{
+	static const size_t count = []
+	{
+		size_t num = 0;
+
+		#ifdef __linux__
+		if (FILE* file = std::fopen("/sys/devices/system/node/online", "r"))
+		{
+			unsigned first = 0, last = 0;
+			char sep = ',';
+
+			while (sep == ',' && std::fscanf(file, "%u", &first) == 1)
+			{
+				last = first;
+
+				if (std::fscanf(file, "%c", &sep) == 1 && sep == '-')
+				{
+					if (std::fscanf(file, "%u%c", &last, &sep) < 1) break;
+				}
+
+				num = std::max<size_t>(num, last + 1);
+			}
+
+			std::fclose(file);
+		}
+		#endif
+
+		return std::max<size_t>(num, 1);
+	}();
+
+	return count;
+}
+
+inline int numa_resource::node_of(const void* ptr)
+{
+	#ifdef __linux__
+	int node = -1;
+
+	if (syscall(SYS_get_mempolicy, &node, nullptr, 0,
+			  const_cast<void*>(ptr), MPOL_F_NODE | MPOL_F_ADDR) == 0)
+	{
+		return node;
+	}
+	#else
+	(void) ptr;
+	#endif
+
+	return -1;
+}
+
+inline bool numa_resource::interleave(void* ptr, size_t bytes)
+{
+	#ifdef __linux__
+	constexpr size_t bits = sizeof(unsigned long) * 8;
+
+	const size_t count = nodes();
+	std::vector<unsigned long> mask(count / bits + 1, 0);
+
+	for (size_t i = 0; i < count; ++i) mask[i / bits] |= 1ul << (i % bits);
+
+	return syscall(SYS_mbind, ptr, get_length(bytes), MPOL_INTERLEAVE,
+				mask.data(), count + 1, 0) == 0;
+	#else
+	(void) ptr; (void) bytes;
+
+	return false;
+	#endif
+}
+
+inline void numa_resource::first_touch(void* ptr, size_t rows, size_t stride, size_t tnum)
+{
+	const size_t page = page_size();
+	char* base = static_cast<char*>(ptr);
+
+	parallel::run(rows, tnum ? tnum : parallel::threads(), [&] (size_t b, size_t e)
+	{
+		const auto begin = reinterpret_cast<uintptr_t>(base + b * stride);
+		const auto end = reinterpret_cast<uintptr_t>(base + e * stride);
+
+		for (auto p = (begin + page - 1) / page * page; p < end; p += page)
+		{
+			volatile char* c = reinterpret_cast<char*>(p); *c = *c;
+		}
+	});
+}
+
+inline numa_resource& numa_resource::global(void)
+{
+	static numa_resource res; return res;
+}
+
+inline huge_resource::huge_resource(size_t threshold, bool hugetlb, bool prefault, matrix_resource& upstream)
+: m_upstream(upstream), m_threshold(std::max<size_t>(threshold, 1)), m_hugetlb(hugetlb), m_prefault(prefault) {}
+
+inline size_t huge_resource::get_length(size_t bytes)
+{
+	return (bytes + s_huge - 1) / s_huge * s_huge;
+}
+
+inline void* huge_resource::allocate(size_t bytes, size_t align)
+{
+	#ifdef __linux__
+	if (bytes >= m_threshold && align <= s_huge)
+	{
+		const size_t len = get_length(bytes);
+		const bool fill = get_prefault();
+
+		#ifdef MAP_HUGETLB
+		if (get_hugetlb())
+		{
+			const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+						   (21 << MAP_HUGE_SHIFT) | (fill ? MAP_POPULATE : 0);
+
+			void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+			if (ptr != MAP_FAILED)
+			{
+				m_mapped.fetch_add(len, std::memory_order_relaxed);
+				m_tlbhits.fetch_add(1, std::memory_order_relaxed);
+
+				return ptr;
+			}
+			else m_fallbacks.fetch_add(1, std::memory_order_relaxed);
+		}
+		#endif
+
+		void* mem = mmap(nullptr, len + s_huge, PROT_READ | PROT_WRITE,
+					  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (mem == MAP_FAILED) return nullptr;
+
+		const auto base = reinterpret_cast<uintptr_t>(mem);
+		const auto start = (base + s_huge - 1) / s_huge * s_huge;
+
+		char* ptr = reinterpret_cast<char*>(start);
+
+		if (start > base) munmap(mem, start - base);
+		munmap(ptr + len, s_huge - (start - base));
+
+		#ifdef MADV_HUGEPAGE
+		madvise(ptr, len, MADV_HUGEPAGE);
+		#endif
+
+		if (fill)
+		{
+			const size_t page = numa_resource::page_size();
+
+			parallel::run(len / page, parallel::threads(), [ptr, page] (size_t b, size_t e)
+			{
+				for (size_t i = b; i < e; ++i) static_cast<volatile char*>(ptr)[i * page] = 0;
+			});
+		}
+
+		m_mapped.fetch_add(len, std::memory_order_relaxed);
+
+		return ptr;
+	}
+	#endif
+
+	return m_upstream.allocate(bytes, align);
+}
+
+inline void huge_resource::deallocate(void* ptr, size_t bytes, size_t align)
+{
+	#ifdef __linux__
+	if (bytes >= m_threshold && align <= s_huge)
+	{
+		const size_t len = get_length(bytes);
+
+		munmap(ptr, len);
+		m_mapped.fetch_sub(len, std::memory_order_relaxed);
+
+		return;
+	}
+	#endif
+
+	m_upstream.deallocate(ptr, bytes, align);
+}
+
+inline size_t huge_resource::get_threshold(void) const
+{
+	return m_threshold;
+}
+
+inline bool huge_resource::get_hugetlb(void) const
+{
+	return m_hugetlb.load(std::memory_order_relaxed);
+}
+
+inline bool huge_resource::set_hugetlb(bool hugetlb)
+{
+	m_hugetlb.store(hugetlb, std::memory_order_relaxed); return true;
+}
+
+inline bool huge_resource::get_prefault(void) const
+{
+	return m_prefault.load(std::memory_order_relaxed);
+}
+
+inline bool huge_resource::set_prefault(bool prefault)
+{
+	m_prefault.store(prefault, std::memory_order_relaxed); return true;
+}
+
+inline size_t huge_resource::mapped(void) const
+{
+	return m_mapped.load(std::memory_order_relaxed);
+}
+
+inline size_t huge_resource::hugetlb(void) const
+{
+	return m_tlbhits.load(std::memory_order_relaxed);
+}
+
+inline size_t huge_resource::fallbacks(void) const
+{
+	return m_fallbacks.load(std::memory_order_relaxed);
+}
+
+inline size_t huge_resource::huge_size(void)
+{
+	return s_huge;
+}
+
+inline size_t huge_resource::huge_bytes(const void* ptr)
+{
+	size_t bytes = 0;
+
+	#ifdef __linux__
+	FILE* file = std::fopen("/proc/self/smaps", "r");
+
+	if (!file) return 0;
+
+	const auto addr = reinterpret_cast<uintptr_t>(ptr);
+	bool inside = false;
+	char line[512];
+
+	while (std::fgets(line, sizeof(line), file))
+	{
+		unsigned long long first = 0, last = 0, size = 0;
+		char name[64];
+
+		if (std::sscanf(line, "%llx-%llx", &first, &last) == 2)
+		{
+			if (inside) break;
+			else inside = addr >= first && addr < last;
+		}
+		else if (inside && std::sscanf(line, "%63s %llu", name, &size) == 2)
+		{
+			if (std::strcmp(name, "AnonHugePages:") == 0 ||
+			    std::strcmp(name, "Private_Hugetlb:") == 0 ||
+			    std::strcmp(name, "Shared_Hugetlb:") == 0)
+			{
+				bytes += size * 1024;
+			}
+		}
+	}
+
+	std::fclose(file);
+	#else
+	(void) ptr;
+	#endif
+
+	return bytes;
+}
+
+inline huge_resource& huge_resource::global(void)
+{
+	static huge_resource res; return res;
+}
+
+#endif
@@ -0,0 +1,306 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RESOURCE_HPP
+#define RESOURCE_HPP
+
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <array>
+#include <mutex>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "parallel.hpp"
+
+class matrix_resource
+{
+
+	protected:
+
+		static thread_local matrix_resource* s_current;
+		static std::atomic<matrix_resource*> s_default;
+
+		friend class resource_scope;
+
+	public:
+
+		virtual ~matrix_resource(void) = default;
+
+		virtual void* allocate(size_t bytes, size_t align) = 0;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) = 0;
+
+		virtual void touch(void* ptr, size_t rows, size_t stride);
+
+		static matrix_resource& current(void);
+
+		static matrix_resource& get_default(void);
+		static matrix_resource& set_default(matrix_resource& res);
+
+		static matrix_resource& heap(void);
+
+};
+
+class resource_scope
+{
+
+	protected:
+
+		matrix_resource* m_last;
+
+	public:
+
+		explicit resource_scope(matrix_resource& res);
+		~resource_scope(void);
+
+		resource_scope(const resource_scope&) = delete;
+		resource_scope& operator= (const resource_scope&) = delete;
+
+};
+
+class heap_resource : public matrix_resource
+{
+
+	public:
+
+		virtual void* allocate(size_t bytes, size_t align) override;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) override;
+
+};
+
+class pool_resource : public matrix_resource
+{
+
+	protected:
+
+		static constexpr size_t s_minshift = 6;
+		static constexpr size_t s_classes = 21;
+
+		struct cache
+		{
+			std::mutex lock;
+			std::array<std::vector<void*>, s_classes> lists;
+
+			bool alive = true;
+		};
+
+		mutable std::mutex m_lock;
+		std::vector<std::shared_ptr<cache>> m_caches;
+
+		matrix_resource& m_upstream;
+
+		std::atomic<size_t> m_keep;
+		std::atomic<size_t> m_hits = 0;
+		std::atomic<size_t> m_misses = 0;
+
+		cache& get_cache(void);
+
+		static size_t get_class(size_t bytes);
+		static size_t get_size(size_t cls);
+
+	public:
+
+		explicit pool_resource(size_t keep = 16, matrix_resource& upstream = matrix_resource::heap());
+		virtual ~pool_resource(void) override;
+
+		pool_resource(const pool_resource&) = delete;
+		pool_resource& operator= (const pool_resource&) = delete;
+
+		virtual void* allocate(size_t bytes, size_t align) override;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) override;
+
+		size_t get_keep(void) const;
+		bool set_keep(size_t keep);
+
+		size_t hits(void) const;
+		size_t misses(void) const;
+		size_t cached(void) const;
+
+		void trim(void);
+
+		static pool_resource& global(void);
+
+};
+
+class arena_resource : public matrix_resource
+{
+
+	protected:
+
+		struct chunk
+		{
+			char* ptr;
+			size_t size;
+		};
+
+		mutable std::mutex m_lock;
+		std::vector<chunk> m_chunks;
+
+		matrix_resource& m_upstream;
+
+		size_t m_chunk;
+		size_t m_offset = 0;
+		size_t m_used = 0;
+
+	public:
+
+		explicit arena_resource(size_t chunk = 1 << 20, matrix_resource& upstream = matrix_resource::heap());
+		virtual ~arena_resource(void) override;
+
+		arena_resource(const arena_resource&) = delete;
+		arena_resource& operator= (const arena_resource&) = delete;
+
+		virtual void* allocate(size_t bytes, size_t align) override;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) override;
+
+		size_t used(void) const;
+		size_t capacity(void) const;
+
+		void release(void);
+
+};
+
+class numa_resource : public matrix_resource
+{
+
+	public:
+
+		enum class mode
+		{
+			local,
+			first_touch,
+			interleave
+		};
+
+	protected:
+
+		matrix_resource& m_upstream;
+
+		std::atomic<mode> m_mode;
+		const size_t m_threshold;
+
+		std::atomic<size_t> m_mapped = 0;
+		std::atomic<size_t> m_failed = 0;
+
+		static size_t get_length(size_t bytes);
+
+	public:
+
+		explicit numa_resource(mode mod = mode::first_touch, size_t threshold = size_t(1) << 20,
+						   matrix_resource& upstream = matrix_resource::heap());
+
+		numa_resource(const numa_resource&) = delete;
+		numa_resource& operator= (const numa_resource&) = delete;
+
+		virtual void* allocate(size_t bytes, size_t align) override;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) override;
+
+		virtual void touch(void* ptr, size_t rows, size_t stride) override;
+
+		mode get_mode(void) const;
+		bool set_mode(mode mod);
+
+		size_t get_threshold(void) const;
+
+		size_t mapped(void) const;
+		size_t failed(void) const;
+
+		static size_t page_size(void);
+		static size_t nodes(void);
+
+		static int node_of(const void* ptr);
+
+		static bool interleave(void* ptr, size_t bytes);
+		static void first_touch(void* ptr, size_t rows, size_t stride, size_t tnum = 0);
+
+		static numa_resource& global(void);
+
+};
+
+class huge_resource : public matrix_resource
+{
+
+	protected:
+
+		static constexpr size_t s_huge = size_t(1) << 21;
+
+		matrix_resource& m_upstream;
+
+		const size_t m_threshold;
+
+		std::atomic<bool> m_hugetlb;
+		std::atomic<bool> m_prefault;
+
+		std::atomic<size_t> m_mapped = 0;
+		std::atomic<size_t> m_tlbhits = 0;
+		std::atomic<size_t> m_fallbacks = 0;
+
+		static size_t get_length(size_t bytes);
+
+	public:
+
+		explicit huge_resource(size_t threshold = s_huge, bool hugetlb = false, bool prefault = false,
+						   matrix_resource& upstream = matrix_resource::heap());
+
+		huge_resource(const huge_resource&) = delete;
+		huge_resource& operator= (const huge_resource&) = delete;
+
+		virtual void* allocate(size_t bytes, size_t align) override;
+		virtual void deallocate(void* ptr, size_t bytes, size_t align) override;
+
+		size_t get_threshold(void) const;
+
+		bool get_hugetlb(void) const;
+		bool set_hugetlb(bool hugetlb);
+
+		bool get_prefault(void) const;
+		bool set_prefault(bool prefault);
+
+		size_t mapped(void) const;
+		size_t hugetlb(void) const;
+		size_t fallbacks(void) const;
+
+		static size_t huge_size(void);
+		static size_t huge_bytes(const void* ptr);
+
+		static huge_resource& global(void);
+
+};
+
+#ifndef RESOURCE_CPP
+#include "resource.cpp"
+#endif
+
+#endif // RESOURCE_HPP
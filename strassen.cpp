@@ -0,0 +1,278 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef STRASSEN_CPP
+#define STRASSEN_CPP
+
+#ifndef STRASSEN_HPP
+#include "strassen.hpp"
+#endif
+
+inline std::atomic<bool> strassen::s_enabled = std::getenv("MATRIX_NO_STRASSEN") == nullptr;
+inline std::atomic<size_t> strassen::s_cutoff = 128;
+inline std::atomic<size_t> strassen::s_threshold = 2048;
+
+inline bool strassen::is_enabled(void)
+{
+	return s_enabled.load(std::memory_order_relaxed);
+}
+
+inline bool strassen::set_enabled(bool enabled)
+{
+	s_enabled.store(enabled, std::memory_order_relaxed); return true;
+}
+
+inline size_t strassen::get_cutoff(void)
+{
+	return s_cutoff.load(std::memory_order_relaxed);
+}
+
+inline bool strassen::set_cutoff(size_t cutoff)
+{
+	if (cutoff < 2) return false;
+
+	s_cutoff.store(cutoff, std::memory_order_relaxed); return true;
+}
+
+inline size_t strassen::get_threshold(void)
+{
+	return s_threshold.load(std::memory_order_relaxed);
+}
+
+inline bool strassen::set_threshold(size_t threshold)
+{
+	s_threshold.store(threshold, std::memory_order_relaxed); return true;
+}
+
+inline bool strassen::is_applicable(size_t m, size_t k, size_t n)
+{
+	return is_enabled() && m == k && k == n && n >= get_threshold() && n > get_cutoff();
+}
+
+inline size_t strassen::padded(size_t n)
+{
+	const size_t cutoff = get_cutoff();
+	size_t levels = 0;
+
+	while ((n >> levels) + ((n & ((size_t(1) << levels) - 1)) != 0) > cutoff) ++levels;
+
+	const size_t step = size_t(1) << levels;
+
+	return (n + step - 1) / step * step;
+}
+
+inline size_t strassen::serial_size(size_t n)
+{
+	if (n <= get_cutoff() || n % 2) return 0;
+	else return 3 * (n / 2) * (n / 2) + serial_size(n / 2);
+}
+
+inline size_t strassen::workspace(size_t n)
+{
+	const size_t size = padded(n), h = size / 2;
+	const size_t pad = size == n ? 0 : 3 * size * size;
+
+	if (size <= get_cutoff()) return pad;
+	else return pad + 11 * h * h + 7 * serial_size(h);
+}
+
+template<typename data>
+void strassen::base(const data* a, size_t lda, const data* b, size_t ldb,
+				data* c, size_t ldc, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		data* row = c + i * ldc;
+
+		std::fill(row, row + n, data(0));
+
+		for (size_t k = 0; k < n; ++k)
+		{
+			const data mul = a[i * lda + k];
+			const data* src = b + k * ldb;
+
+			for (size_t j = 0; j < n; ++j) row[j] += mul * src[j];
+		}
+	}
+}
+
+template<typename data>
+void strassen::add(const data* a, size_t lda, const data* b, size_t ldb,
+			    data* c, size_t ldc, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		for (size_t j = 0; j < n; ++j)
+			c[i * ldc + j] = a[i * lda + j] + b[i * ldb + j];
+}
+
+template<typename data>
+void strassen::sub(const data* a, size_t lda, const data* b, size_t ldb,
+			    data* c, size_t ldc, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		for (size_t j = 0; j < n; ++j)
+			c[i * ldc + j] = a[i * lda + j] - b[i * ldb + j];
+}
+
+template<typename data>
+void strassen::serial(const data* a, size_t lda, const data* b, size_t ldb,
+				  data* c, size_t ldc, size_t n, data* work)
+{
+	if (n <= get_cutoff() || n % 2) return base(a, lda, b, ldb, c, ldc, n);
+
+	const size_t h = n / 2;
+
+	const data *a11 = a, *a12 = a + h, *a21 = a + h * lda, *a22 = a21 + h;
+	const data *b11 = b, *b12 = b + h, *b21 = b + h * ldb, *b22 = b21 + h;
+	data *c11 = c, *c12 = c + h, *c21 = c + h * ldc, *c22 = c21 + h;
+
+	data* x = work;
+	data* y = x + h * h;
+	data* z = y + h * h;
+	data* next = z + h * h;
+
+	sub(a11, lda, a21, lda, x, h, h);
+	sub(b22, ldb, b12, ldb, y, h, h);
+	serial(x, h, y, h, c21, ldc, h, next);
+
+	add(a21, lda, a22, lda, x, h, h);
+	sub(b12, ldb, b11, ldb, y, h, h);
+	serial(x, h, y, h, c22, ldc, h, next);
+
+	sub(x, h, a11, lda, x, h, h);
+	sub(b22, ldb, y, h, y, h, h);
+	serial(x, h, y, h, c12, ldc, h, next);
+
+	sub(a12, lda, x, h, x, h, h);
+	serial(x, h, b22, ldb, c11, ldc, h, next);
+
+	serial(a11, lda, b11, ldb, z, h, h, next);
+
+	add(c12, ldc, z, h, c12, ldc, h);
+	add(c21, ldc, c12, ldc, c21, ldc, h);
+	add(c12, ldc, c22, ldc, c12, ldc, h);
+	add(c21, ldc, c22, ldc, c22, ldc, h);
+	add(c12, ldc, c11, ldc, c12, ldc, h);
+
+	sub(y, h, b21, ldb, y, h, h);
+	serial(a22, lda, y, h, c11, ldc, h, next);
+	sub(c21, ldc, c11, ldc, c21, ldc, h);
+
+	serial(a12, lda, b21, ldb, c11, ldc, h, next);
+	add(c11, ldc, z, h, c11, ldc, h);
+}
+
+template<typename data>
+void strassen::top(const data* a, size_t lda, const data* b, size_t ldb,
+			    data* c, size_t ldc, size_t n, data* work, size_t tnum)
+{
+	const size_t h = n / 2, hh = h * h;
+
+	const data *a11 = a, *a12 = a + h, *a21 = a + h * lda, *a22 = a21 + h;
+	const data *b11 = b, *b12 = b + h, *b21 = b + h * ldb, *b22 = b21 + h;
+	data *c11 = c, *c12 = c + h, *c21 = c + h * ldc, *c22 = c21 + h;
+
+	data *s1 = work, *s2 = s1 + hh, *s3 = s2 + hh, *s4 = s3 + hh;
+	data *t1 = s4 + hh, *t2 = t1 + hh, *t3 = t2 + hh, *t4 = t3 + hh;
+	data *m1 = t4 + hh, *m6 = m1 + hh, *m7 = m6 + hh;
+	data* next = m7 + hh;
+
+	add(a21, lda, a22, lda, s1, h, h);
+	sub(s1, h, a11, lda, s2, h, h);
+	sub(a11, lda, a21, lda, s3, h, h);
+	sub(a12, lda, s2, h, s4, h, h);
+
+	sub(b12, ldb, b11, ldb, t1, h, h);
+	sub(b22, ldb, t1, h, t2, h, h);
+	sub(b22, ldb, b12, ldb, t3, h, h);
+	sub(t2, h, b21, ldb, t4, h, h);
+
+	const size_t step = serial_size(h);
+
+	parallel::run(7, tnum, [&] (size_t lo, size_t hi)
+	{
+		for (size_t id = lo; id < hi; ++id)
+		{
+			data* ws = next + id * step;
+
+			switch (id)
+			{
+				case 0: serial(a11, lda, b11, ldb, m1, h, h, ws); break;
+				case 1: serial(a12, lda, b21, ldb, c11, ldc, h, ws); break;
+				case 2: serial(s4, h, b22, ldb, c12, ldc, h, ws); break;
+				case 3: serial(a22, lda, t4, h, c21, ldc, h, ws); break;
+				case 4: serial(s1, h, t1, h, c22, ldc, h, ws); break;
+				case 5: serial(s2, h, t2, h, m6, h, h, ws); break;
+				case 6: serial(s3, h, t3, h, m7, h, h, ws); break;
+			}
+		}
+	});
+
+	add(m1, h, m6, h, m6, h, h);
+	add(c11, ldc, m1, h, c11, ldc, h);
+	add(m6, h, m7, h, m7, h, h);
+
+	add(c12, ldc, m6, h, c12, ldc, h);
+	add(c12, ldc, c22, ldc, c12, ldc, h);
+	add(m7, h, c22, ldc, c22, ldc, h);
+	sub(m7, h, c21, ldc, c21, ldc, h);
+}
+
+template<typename data>
+bool strassen::multiply(const data* a, const data* b, data* c, size_t n,
+				    data* work, size_t size, size_t tnum)
+{
+	const size_t full = padded(n);
+
+	if (n == 0 || size < workspace(n)) return false;
+	else if (full <= get_cutoff())
+	{
+		base(a, n, b, n, c, n, n); return true;
+	}
+
+	if (tnum == 0) tnum = parallel::threads();
+
+	if (full == n) top(a, n, b, n, c, n, n, work, tnum);
+	else
+	{
+		data* pa = work;
+		data* pb = pa + full * full;
+		data* pc = pb + full * full;
+
+		std::fill(pa, pa + 2 * full * full, data(0));
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::copy(a + i * n, a + (i + 1) * n, pa + i * full);
+			std::copy(b + i * n, b + (i + 1) * n, pb + i * full);
+		}
+
+		top(pa, full, pb, full, pc, full, full, pc + full * full, tnum);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::copy(pc + i * full, pc + i * full + n, c + i * n);
+		}
+	}
+
+	return true;
+}
+
+#endif
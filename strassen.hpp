@@ -0,0 +1,89 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef STRASSEN_HPP
+#define STRASSEN_HPP
+
+#include <algorithm>
+#include <atomic>
+
+#include <cstddef>
+#include <cstdlib>
+
+#include "parallel.hpp"
+
+class strassen
+{
+
+	protected:
+
+		static std::atomic<bool> s_enabled;
+		static std::atomic<size_t> s_cutoff;
+		static std::atomic<size_t> s_threshold;
+
+		template<typename data>
+		static void base(const data* a, size_t lda, const data* b, size_t ldb,
+					  data* c, size_t ldc, size_t n);
+
+		template<typename data>
+		static void add(const data* a, size_t lda, const data* b, size_t ldb,
+					 data* c, size_t ldc, size_t n);
+
+		template<typename data>
+		static void sub(const data* a, size_t lda, const data* b, size_t ldb,
+					 data* c, size_t ldc, size_t n);
+
+		template<typename data>
+		static void serial(const data* a, size_t lda, const data* b, size_t ldb,
+					    data* c, size_t ldc, size_t n, data* work);
+
+		template<typename data>
+		static void top(const data* a, size_t lda, const data* b, size_t ldb,
+					 data* c, size_t ldc, size_t n, data* work, size_t tnum);
+
+		static size_t serial_size(size_t n);
+
+	public:
+
+		static bool is_enabled(void);
+		static bool set_enabled(bool enabled);
+
+		static size_t get_cutoff(void);
+		static bool set_cutoff(size_t cutoff);
+
+		static size_t get_threshold(void);
+		static bool set_threshold(size_t threshold);
+
+		static bool is_applicable(size_t m, size_t k, size_t n);
+
+		static size_t padded(size_t n);
+		static size_t workspace(size_t n);
+
+		template<typename data>
+		static bool multiply(const data* a, const data* b, data* c, size_t n,
+						 data* work, size_t size, size_t tnum = 0);
+
+};
+
+#ifndef STRASSEN_CPP
+#include "strassen.cpp"
+#endif
+
+#endif // STRASSEN_HPP
@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	strassen::set_enabled(false);
+
+	matrix<double> a(100, 100), b(100, 100);
+	matrix<int> ia(64, 64), ib(64, 64);
+
+	for (size_t i = 0; i < 100; ++i)
+		for (size_t j = 0; j < 100; ++j)
+		{
+			a(i, j) = double((i * 7 + j * 3) % 11) / 3.0 - 1.5;
+			b(i, j) = double((i * 5 + j * 2) % 13) / 5.0 - 1.0;
+		}
+
+	for (size_t i = 0; i < 64; ++i)
+		for (size_t j = 0; j < 64; ++j)
+		{
+			ia(i, j) = int((i * 3 + j) % 7) - 3;
+			ib(i, j) = int((i + j * 5) % 9) - 4;
+		}
+
+	const auto ab = a * b;
+	const auto iab = ia * ib;
+
+	if (strassen::set_cutoff(1) || !strassen::set_cutoff(16) || !strassen::set_threshold(32)) endtest(n, ok);
+	if (strassen::is_applicable(100, 100, 100) || strassen::padded(100) != 104) endtest(n, ok);
+
+	strassen::set_enabled(true);
+
+	if (!strassen::is_applicable(64, 64, 64) || strassen::is_applicable(64, 32, 64)) endtest(n, ok);
+	if (strassen::is_applicable(16, 16, 16) || strassen::workspace(64) == 0) endtest(n, ok);
+
+	if (ia * ib != iab) endtest(n, ok);
+
+	const auto sab = a * b;
+
+	if (sab.rows() != 100 || sab.cols() != 100) endtest(n, ok);
+	if ((sab - ab).apply([] (double v) { return std::fabs(v); }).max() > 1e-9) endtest(n, ok);
+
+	std::vector<int> work(strassen::workspace(64));
+	matrix<int> ic(64, 64);
+
+	if (strassen::multiply(&ia(0, 0), &ib(0, 0), &ic(0, 0), 64,
+					   work.data(), work.size() - 1)) endtest(n, ok);
+
+	for (size_t t : { 1, 4 })
+	{
+		ic.clear(); ic.resize(64, 64);
+
+		if (!strassen::multiply(&ia(0, 0), &ib(0, 0), &ic(0, 0), 64, work.data(), work.size(), t) ||
+		    ic != iab) endtest(n, ok);
+	}
+
+	strassen::set_enabled(false);
+
+	if (a * b != ab) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,477 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef SYMMETRIC_CPP
+#define SYMMETRIC_CPP
+
+#ifndef SYMMETRIC_HPP
+#include "symmetric.hpp"
+#endif
+
+template<typename data>
+symmetric_matrix<data>::symmetric_matrix(size_t size)
+{
+	resize(size);
+}
+
+template<typename data>
+symmetric_matrix<data>::symmetric_matrix(size_t size, const data& val)
+{
+	if (resize(size)) std::fill(m_ptr, m_ptr + packed(), val);
+}
+
+template<typename data> template<typename layout>
+symmetric_matrix<data>::symmetric_matrix(const matrix<data, layout>& mat)
+{
+	if (!mat.is_square() || !resize(mat.rows())) return;
+
+	for (size_t i = 0; i < m_size; ++i)
+		for (size_t j = 0; j <= i; ++j)
+			row(i)[j] = mat(i, j);
+}
+
+template<typename data>
+symmetric_matrix<data>::symmetric_matrix(const symmetric_matrix<data>& other)
+{
+	*this = other;
+}
+
+template<typename data>
+symmetric_matrix<data>::symmetric_matrix(symmetric_matrix<data>&& other)
+{
+	*this = std::move(other);
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::get_threads(size_t work)
+{
+	switch (exec_policy::current().get_kind())
+	{
+	case exec_policy::kind::seq: return 1;
+	case exec_policy::kind::automatic: break;
+	default: return parallel::threads();
+	}
+
+	return cost_model::global().threads(cost_model::op::gemm, work, sizeof(data));
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::get_offset(size_t row)
+{
+	return row * (row + 1) / 2;
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::get_bound(size_t size, size_t parts, size_t id)
+{
+	if (id >= parts) return size;
+	else return std::min(size, size_t(std::sqrt(double(id) / double(parts)) * double(size)));
+}
+
+template<typename data> template<typename fun>
+void symmetric_matrix<data>::run_lower(size_t first, size_t last, size_t tnum, const fun& f)
+{
+	if (first >= last) return;
+	else if (tnum <= 1) return f(first, last);
+
+	const size_t count = last - first;
+	tnum = std::min(tnum, count);
+
+	parallel::run(tnum, tnum, [&] (size_t lo, size_t hi)
+	{
+		for (size_t t = lo; t < hi; ++t)
+		{
+			const size_t b = get_bound(count, tnum, t);
+			const size_t e = get_bound(count, tnum, t + 1);
+
+			if (b < e) f(first + b, first + e);
+		}
+	});
+}
+
+template<typename data>
+data* symmetric_matrix<data>::row(size_t n)
+{
+	return m_ptr + get_offset(n);
+}
+
+template<typename data>
+const data* symmetric_matrix<data>::row(size_t n) const
+{
+	return m_ptr + get_offset(n);
+}
+
+template<typename data>
+data symmetric_matrix<data>::dot(const data* a, const data* b, size_t count)
+{
+	data sum = data(0);
+
+	for (size_t i = 0; i < count; ++i) sum += a[i] * b[i];
+
+	return sum;
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::rows(void) const
+{
+	return m_size;
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::cols(void) const
+{
+	return m_size;
+}
+
+template<typename data>
+size_t symmetric_matrix<data>::packed(void) const
+{
+	return get_offset(m_size);
+}
+
+template<typename data>
+bool symmetric_matrix<data>::resize(size_t size)
+{
+	if (size == m_size) return false;
+	else if (size > 0) clear();
+	else return false;
+
+	const size_t bytes = get_offset(size) * sizeof(data);
+
+	auto& res = matrix_resource::current();
+	void* ptr = res.allocate(bytes, alignof(data));
+
+	if (ptr)
+	{
+		alloc_tracker::allocated(bytes);
+
+		m_ptr = static_cast<data*>(ptr);
+		m_res = &res;
+		m_size = size;
+	}
+
+	return m_ptr != nullptr;
+}
+
+template<typename data>
+bool symmetric_matrix<data>::clear(void)
+{
+	if (m_ptr == nullptr) return false;
+
+	const size_t bytes = packed() * sizeof(data);
+
+	m_res->deallocate(m_ptr, bytes, alignof(data));
+	alloc_tracker::released(bytes);
+
+	m_ptr = nullptr;
+	m_res = nullptr;
+	m_size = 0;
+	m_factored = false;
+
+	return true;
+}
+
+template<typename data>
+bool symmetric_matrix<data>::is_valid(void) const
+{
+	return m_ptr != nullptr;
+}
+
+template<typename data>
+bool symmetric_matrix<data>::is_factored(void) const
+{
+	return m_factored;
+}
+
+template<typename data>
+data& symmetric_matrix<data>::get_val(size_t row, size_t col)
+{
+	if (row < col) std::swap(row, col);
+
+	return m_ptr[get_offset(row) + col];
+}
+
+template<typename data>
+const data& symmetric_matrix<data>::get_val(size_t row, size_t col) const
+{
+	if (row < col) std::swap(row, col);
+
+	return m_ptr[get_offset(row) + col];
+}
+
+template<typename data>
+bool symmetric_matrix<data>::set_val(size_t row, size_t col, const data& val)
+{
+	if (row >= m_size || col >= m_size) return false;
+	else get_val(row, col) = val;
+
+	return true;
+}
+
+template<typename data>
+matrix<data> symmetric_matrix<data>::to_matrix(void) const
+{
+	matrix<data> res(m_size, m_size, data(0));
+
+	for (size_t i = 0; i < m_size; ++i)
+		for (size_t j = 0; j <= i; ++j)
+		{
+			res(i, j) = row(i)[j];
+
+			if (!m_factored) res(j, i) = row(i)[j];
+		}
+
+	return res;
+}
+
+template<typename data>
+bool symmetric_matrix<data>::cholesky(const exec_policy& pol)
+{
+	if (!is_valid() || m_factored) return false;
+
+	MATRIX_PROFILE_SCOPE("cholesky", packed());
+
+	policy_scope scope(pol);
+
+	const size_t tnum = get_threads(packed() * m_size / 3);
+
+	for (size_t k0 = 0; k0 < m_size; k0 += s_block)
+	{
+		const size_t k1 = std::min(k0 + s_block, m_size);
+
+		for (size_t i = k0; i < k1; ++i)
+		{
+			data* ri = row(i);
+
+			for (size_t j = k0; j <= i; ++j)
+			{
+				const data sum = ri[j] - dot(ri + k0, row(j) + k0, j - k0);
+
+				if (i != j) ri[j] = sum / row(j)[j];
+				else if (sum > data(0)) ri[i] = std::sqrt(sum);
+				else return false;
+			}
+		}
+
+		parallel::run(m_size - k1, tnum, [&] (size_t lo, size_t hi)
+		{
+			for (size_t i = k1 + lo; i < k1 + hi; ++i)
+			{
+				data* ri = row(i);
+
+				for (size_t j = k0; j < k1; ++j)
+				{
+					ri[j] = (ri[j] - dot(ri + k0, row(j) + k0, j - k0)) / row(j)[j];
+				}
+			}
+		});
+
+		run_lower(k1, m_size, tnum, [&] (size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; ++i)
+			{
+				data* ri = row(i);
+
+				for (size_t j = k1; j <= i; ++j)
+				{
+					ri[j] -= dot(ri + k0, row(j) + k0, k1 - k0);
+				}
+			}
+		});
+	}
+
+	return m_factored = true;
+}
+
+template<typename data> template<typename layout>
+bool symmetric_matrix<data>::solve(matrix<data, layout>& b, const exec_policy& pol) const
+{
+	if (!m_factored || b.rows() != m_size) return false;
+
+	if constexpr (!std::is_same_v<layout, row_major>)
+	{
+		matrix<data> tmp(b);
+
+		return solve(tmp, pol) && tmp.copy_into(b);
+	}
+	else
+	{
+		MATRIX_PROFILE_SCOPE("cholesky_solve", b.size());
+
+		policy_scope scope(pol);
+
+		const size_t k = b.m_cols;
+
+		b.detach();
+
+		parallel::run(k, get_threads(packed() * k), [&] (size_t lo, size_t hi)
+		{
+			for (size_t i = 0; i < m_size; ++i)
+			{
+				const data* li = row(i);
+				data* bi = b.m_ptr + i * k;
+
+				for (size_t j = 0; j < i; ++j)
+				{
+					const data mul = li[j];
+					const data* bj = b.m_ptr + j * k;
+
+					for (size_t c = lo; c < hi; ++c) bi[c] -= mul * bj[c];
+				}
+
+				for (size_t c = lo; c < hi; ++c) bi[c] /= li[i];
+			}
+
+			for (size_t i = m_size; i-- > 0;)
+			{
+				const data* li = row(i);
+				data* bi = b.m_ptr + i * k;
+
+				for (size_t c = lo; c < hi; ++c) bi[c] /= li[i];
+
+				for (size_t j = 0; j < i; ++j)
+				{
+					const data mul = li[j];
+					data* bj = b.m_ptr + j * k;
+
+					for (size_t c = lo; c < hi; ++c) bj[c] -= mul * bi[c];
+				}
+			}
+		});
+
+		return true;
+	}
+}
+
+template<typename data> template<typename layout>
+matrix<data, layout> symmetric_matrix<data>::solve(const matrix<data, layout>& b, const exec_policy& pol) const
+{
+	matrix<data, layout> res = b;
+
+	if (!solve(res, pol)) return matrix<data, layout>();
+	else return res;
+}
+
+template<typename data>
+data& symmetric_matrix<data>::operator() (size_t row, size_t col)
+{
+	return get_val(row, col);
+}
+
+template<typename data>
+const data& symmetric_matrix<data>::operator() (size_t row, size_t col) const
+{
+	return get_val(row, col);
+}
+
+template<typename data>
+symmetric_matrix<data>& symmetric_matrix<data>::operator= (const symmetric_matrix<data>& other)
+{
+	if (&other == this) return *this;
+	else resize(other.m_size);
+
+	std::copy(other.m_ptr, other.m_ptr + packed(), m_ptr);
+	m_factored = other.m_factored;
+
+	return *this;
+}
+
+template<typename data>
+symmetric_matrix<data>& symmetric_matrix<data>::operator= (symmetric_matrix<data>&& other)
+{
+	if (&other != this) clear();
+	else return *this;
+
+	std::swap(m_ptr, other.m_ptr);
+	std::swap(m_res, other.m_res);
+	std::swap(m_size, other.m_size);
+	std::swap(m_factored, other.m_factored);
+
+	return *this;
+}
+
+template<typename data>
+symmetric_matrix<data>::~symmetric_matrix(void)
+{
+	clear();
+}
+
+template<typename data> template<typename layout>
+bool symmetric_matrix<data>::syrk(const data& alpha, const matrix<data, layout>& a, const data& beta,
+						    symmetric_matrix<data>& c, bool trans, const exec_policy& pol)
+{
+	if constexpr (!matrix<data, layout>::s_linear)
+	{
+		return syrk(alpha, matrix<data>(a), beta, c, trans, pol);
+	}
+	else
+	{
+		const size_t n = trans ? a.m_cols : a.m_rows, k = trans ? a.m_rows : a.m_cols;
+
+		if (!a.is_valid()) return false;
+		else if (c.m_size != n && (beta != data(0) || !c.resize(n))) return false;
+
+		MATRIX_PROFILE_SCOPE("syrk", c.packed());
+
+		policy_scope scope(pol);
+
+		const size_t rs = layout::col_order ? 1 : a.m_cols;
+		const size_t cs = layout::col_order ? a.m_rows : 1;
+
+		const size_t ps = trans ? cs : rs, ks = trans ? rs : cs;
+
+		c.m_factored = false;
+
+		run_lower(0, n, get_threads(c.packed() * k), [&] (size_t lo, size_t hi)
+		{
+			for (size_t i = lo; i < hi; ++i)
+			{
+				data* out = c.row(i);
+				const data* vi = a.m_ptr + i * ps;
+
+				if (ks == 1) for (size_t j = 0; j <= i; ++j)
+				{
+					const data sum = alpha * dot(vi, a.m_ptr + j * ps, k);
+
+					out[j] = sum + (beta == data(0) ? data(0) : beta * out[j]);
+				}
+				else
+				{
+					for (size_t j = 0; j <= i; ++j)
+					{
+						out[j] = beta == data(0) ? data(0) : beta * out[j];
+					}
+
+					for (size_t l = 0; l < k; ++l)
+					{
+						const data mul = alpha * vi[l * ks];
+						const data* src = a.m_ptr + l * ks;
+
+						for (size_t j = 0; j <= i; ++j) out[j] += mul * src[j * ps];
+					}
+				}
+			}
+		});
+
+		return true;
+	}
+}
+
+#endif
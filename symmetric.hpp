@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef SYMMETRIC_HPP
+#define SYMMETRIC_HPP
+
+#include <algorithm>
+#include <utility>
+
+#include <cstddef>
+#include <cmath>
+
+#ifndef MATRIX_CHOLESKY_BLOCK
+#define MATRIX_CHOLESKY_BLOCK 64
+#endif
+
+#include "matrix.hpp"
+
+template<typename data = double>
+class symmetric_matrix
+{
+
+	protected:
+
+		static constexpr size_t s_block = MATRIX_CHOLESKY_BLOCK;
+
+		data* m_ptr = nullptr;
+		matrix_resource* m_res = nullptr;
+
+		size_t m_size = 0;
+
+		bool m_factored = false;
+
+		static size_t get_threads(size_t work);
+		static size_t get_offset(size_t row);
+		static size_t get_bound(size_t size, size_t parts, size_t id);
+
+		template<typename fun>
+		static void run_lower(size_t first, size_t last, size_t tnum, const fun& f);
+
+		data* row(size_t n);
+		const data* row(size_t n) const;
+
+		static data dot(const data* a, const data* b, size_t count);
+
+	public:
+
+		explicit symmetric_matrix(size_t size);
+		symmetric_matrix(size_t size, const data& val);
+
+		template<typename layout>
+		explicit symmetric_matrix(const matrix<data, layout>& mat);
+
+		symmetric_matrix(void) = default;
+
+		symmetric_matrix(const symmetric_matrix<data>& other);
+		symmetric_matrix(symmetric_matrix<data>&& other);
+
+		size_t rows(void) const;
+		size_t cols(void) const;
+		size_t packed(void) const;
+
+		bool resize(size_t size);
+		bool clear(void);
+
+		bool is_valid(void) const;
+		bool is_factored(void) const;
+
+		data& get_val(size_t row, size_t col);
+		const data& get_val(size_t row, size_t col) const;
+		bool set_val(size_t row, size_t col, const data& val);
+
+		matrix<data> to_matrix(void) const;
+
+		bool cholesky(const exec_policy& pol = exec_policy::automatic);
+
+		template<typename layout>
+		bool solve(matrix<data, layout>& b, const exec_policy& pol = exec_policy::automatic) const;
+
+		template<typename layout>
+		matrix<data, layout> solve(const matrix<data, layout>& b,
+							  const exec_policy& pol = exec_policy::automatic) const;
+
+		data& operator() (size_t row, size_t col);
+		const data& operator() (size_t row, size_t col) const;
+
+		symmetric_matrix<data>& operator= (const symmetric_matrix<data>& other);
+		symmetric_matrix<data>& operator= (symmetric_matrix<data>&& other);
+
+		~symmetric_matrix(void);
+
+		template<typename layout>
+		static bool syrk(const data& alpha, const matrix<data, layout>& a, const data& beta,
+					  symmetric_matrix<data>& c, bool trans = true,
+					  const exec_policy& pol = exec_policy::automatic);
+
+};
+
+#ifndef SYMMETRIC_CPP
+#include "symmetric.cpp"
+#endif
+
+#endif // SYMMETRIC_HPP
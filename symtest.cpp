@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "symmetric.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	matrix<double> x(90, 7);
+
+	for (size_t i = 0; i < 90; ++i)
+		for (size_t j = 0; j < 7; ++j)
+			x(i, j) = double((i * 3 + j * 7) % 11) - 5.0;
+
+	const matrix<double> xtx = x.transpose() * x;
+	const matrix<double> xxt = x * x.transpose();
+	const matrix<double, col_major> xc = x;
+
+	symmetric_matrix<double> c, d;
+
+	if (!symmetric_matrix<double>::syrk(1.0, x, 0.0, c) || c.rows() != 7 || c.packed() != 28) endtest(n, ok);
+	if (c.to_matrix() != xtx || c(2, 5) != xtx(5, 2) || c(5, 2) != xtx(2, 5)) endtest(n, ok);
+	if (!symmetric_matrix<double>::syrk(1.0, x, 0.0, d, false) || d.to_matrix() != xxt) endtest(n, ok);
+	if (!symmetric_matrix<double>::syrk(1.0, xc, 0.0, d, false) || d.to_matrix() != xxt) endtest(n, ok);
+	if (!symmetric_matrix<double>::syrk(2.0, xc, -1.0, c) || c.to_matrix() != xtx) endtest(n, ok);
+	if (symmetric_matrix<double>::syrk(1.0, x, 1.0, d) || symmetric_matrix<double>(x).is_valid()) endtest(n, ok);
+
+	const size_t size = 150;
+	matrix<double> y(size + 20, size);
+
+	for (size_t i = 0; i < y.rows(); ++i)
+		for (size_t j = 0; j < size; ++j)
+			y(i, j) = std::sin(double(i * size + j));
+
+	symmetric_matrix<double> a;
+
+	if (!symmetric_matrix<double>::syrk(1.0, y, 0.0, a)) endtest(n, ok);
+
+	for (size_t i = 0; i < size; ++i) a(i, i) += 1.0;
+
+	const matrix<double> dense = a.to_matrix();
+	symmetric_matrix<double> l = a;
+
+	if (symmetric_matrix<double>(dense).to_matrix() != dense) endtest(n, ok);
+	if (a.solve(dense).is_valid() || !l.cholesky() || !l.is_factored() || l.cholesky()) endtest(n, ok);
+
+	const matrix<double> lm = l.to_matrix();
+
+	if (lm(0, 1) != 0.0 || ((lm * lm.transpose()) - dense).apply([] (double v) { return std::fabs(v); }).max() > 1e-9) endtest(n, ok);
+
+	matrix<double> sol(size, 3);
+
+	for (size_t i = 0; i < size; ++i)
+		for (size_t j = 0; j < 3; ++j)
+			sol(i, j) = double(i % 5) - double(j);
+
+	const matrix<double> rhs = dense * sol;
+	const matrix<double, col_major> rhc = rhs;
+
+	if ((l.solve(rhs) - sol).apply([] (double v) { return std::fabs(v); }).max() > 1e-8) endtest(n, ok);
+	if ((matrix<double>(l.solve(rhc)) - sol).apply([] (double v) { return std::fabs(v); }).max() > 1e-8) endtest(n, ok);
+
+	symmetric_matrix<double> s = l, p = a, q;
+
+	if (!p.cholesky(exec_policy::seq) || p.to_matrix() != lm) endtest(n, ok);
+	if (!symmetric_matrix<double>::syrk(1.0, y, 0.0, q, true, exec_policy::par)) endtest(n, ok);
+
+	for (size_t i = 0; i < size; ++i) q(i, i) += 1.0;
+
+	if (q.to_matrix() != dense || !q.cholesky(exec_policy::par) || q.to_matrix() != lm) endtest(n, ok);
+	if (l.solve(rhs, exec_policy::par) != l.solve(rhs, exec_policy::seq)) endtest(n, ok);
+	if (s.solve(rhs) != l.solve(rhs) || !s.is_factored()) endtest(n, ok);
+
+	symmetric_matrix<double> bad(2, 1.0);
+
+	if (bad.cholesky() || bad.is_factored()) endtest(n, ok);
+
+	return !(n == ok);
+}
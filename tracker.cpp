@@ -0,0 +1,192 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TRACKER_CPP
+#define TRACKER_CPP
+
+#ifndef TRACKER_HPP
+#include "tracker.hpp"
+#endif
+
+inline std::atomic<bool> alloc_tracker::s_enabled = std::getenv("MATRIX_TRACK_ALLOC") != nullptr;
+
+inline std::atomic<size_t> alloc_tracker::s_count = 0;
+inline std::atomic<size_t> alloc_tracker::s_bytes = 0;
+inline std::atomic<int64_t> alloc_tracker::s_live = 0;
+inline std::atomic<int64_t> alloc_tracker::s_peak = 0;
+
+inline std::mutex alloc_tracker::s_lock;
+inline std::map<std::string, alloc_tracker::record> alloc_tracker::s_sites;
+
+inline thread_local const char* alloc_tracker::s_site = nullptr;
+inline thread_local size_t alloc_tracker::s_tcount = 0;
+inline thread_local size_t alloc_tracker::s_tbytes = 0;
+
+inline alloc_tracker::site::site(const char* name)
+: m_last(s_site)
+{
+	s_site = name;
+}
+
+inline alloc_tracker::site::~site(void)
+{
+	s_site = m_last;
+}
+
+inline alloc_tracker::guard::guard(size_t limit, const char* name, bool strict)
+: m_name(name), m_limit(limit), m_count(s_tcount), m_bytes(s_tbytes), m_strict(strict) {}
+
+inline alloc_tracker::guard::~guard(void)
+{
+	if (is_ok()) return;
+
+	std::cerr << "Allocation guard '" << m_name << "' exceeded: "
+			<< count() << " allocations (" << bytes() << " bytes), limit "
+			<< m_limit << std::endl;
+
+	if (m_strict) std::abort();
+}
+
+inline size_t alloc_tracker::guard::count(void) const
+{
+	return s_tcount - m_count;
+}
+
+inline size_t alloc_tracker::guard::bytes(void) const
+{
+	return s_tbytes - m_bytes;
+}
+
+inline bool alloc_tracker::guard::is_ok(void) const
+{
+	return count() <= m_limit;
+}
+
+inline void alloc_tracker::allocated(size_t bytes)
+{
+	s_tcount += 1;
+	s_tbytes += bytes;
+
+	if (!s_enabled.load(std::memory_order_relaxed)) return;
+
+	s_count.fetch_add(1, std::memory_order_relaxed);
+	s_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+	const int64_t live = s_live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	int64_t peak = s_peak.load(std::memory_order_relaxed);
+
+	while (live > peak && !s_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+	std::lock_guard<std::mutex> lock(s_lock);
+	auto& rec = s_sites[s_site ? s_site : "unscoped"];
+
+	rec.count += 1;
+	rec.bytes += bytes;
+}
+
+inline void alloc_tracker::released(size_t bytes)
+{
+	if (s_enabled.load(std::memory_order_relaxed))
+	{
+		s_live.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+}
+
+inline bool alloc_tracker::is_enabled(void)
+{
+	return s_enabled.load(std::memory_order_relaxed);
+}
+
+inline bool alloc_tracker::set_enabled(bool enabled)
+{
+	s_enabled.store(enabled, std::memory_order_relaxed); return true;
+}
+
+inline alloc_tracker::stats alloc_tracker::totals(void)
+{
+	stats out;
+
+	out.count = s_count.load(std::memory_order_relaxed);
+	out.bytes = s_bytes.load(std::memory_order_relaxed);
+	out.live = std::max<int64_t>(0, s_live.load(std::memory_order_relaxed));
+	out.peak = std::max<int64_t>(0, s_peak.load(std::memory_order_relaxed));
+
+	return out;
+}
+
+inline std::map<std::string, alloc_tracker::record> alloc_tracker::sites(void)
+{
+	std::lock_guard<std::mutex> lock(s_lock); return s_sites;
+}
+
+inline size_t alloc_tracker::thread_count(void)
+{
+	return s_tcount;
+}
+
+inline size_t alloc_tracker::thread_bytes(void)
+{
+	return s_tbytes;
+}
+
+inline const char* alloc_tracker::current_site(void)
+{
+	return s_site;
+}
+
+inline bool alloc_tracker::print(std::ostream& stream)
+{
+	const auto sum = totals();
+	const auto list = sites();
+
+	stream << "allocations: " << sum.count << ", bytes: " << sum.bytes
+		  << ", live: " << sum.live << ", peak: " << sum.peak << std::endl;
+
+	std::vector<std::pair<std::string, record>> sorted(list.begin(), list.end());
+
+	std::sort(sorted.begin(), sorted.end(), [] (const auto& a, const auto& b)
+	{
+		return a.second.count > b.second.count;
+	});
+
+	stream << std::left << std::setw(24) << "site" << std::right
+		  << std::setw(12) << "count" << std::setw(16) << "bytes" << std::endl;
+
+	for (const auto& [name, rec] : sorted)
+	{
+		stream << std::left << std::setw(24) << name << std::right
+			  << std::setw(12) << rec.count << std::setw(16) << rec.bytes << std::endl;
+	}
+
+	return !stream.fail();
+}
+
+inline void alloc_tracker::reset(void)
+{
+	std::lock_guard<std::mutex> lock(s_lock);
+
+	s_sites.clear();
+
+	s_count.store(0, std::memory_order_relaxed);
+	s_bytes.store(0, std::memory_order_relaxed);
+	s_peak.store(s_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#endif
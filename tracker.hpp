@@ -0,0 +1,142 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TRACKER_HPP
+#define TRACKER_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <map>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+
+class alloc_tracker
+{
+
+	public:
+
+		struct record
+		{
+			size_t count = 0;
+			size_t bytes = 0;
+		};
+
+		struct stats
+		{
+			size_t count = 0;
+			size_t bytes = 0;
+			size_t live = 0;
+			size_t peak = 0;
+		};
+
+		class site
+		{
+
+			protected:
+
+				const char* m_last;
+
+			public:
+
+				explicit site(const char* name);
+				~site(void);
+
+				site(const site&) = delete;
+				site& operator= (const site&) = delete;
+
+		};
+
+		class guard
+		{
+
+			protected:
+
+				const char* m_name;
+
+				size_t m_limit;
+				size_t m_count;
+				size_t m_bytes;
+
+				bool m_strict;
+
+			public:
+
+				explicit guard(size_t limit, const char* name = "scope", bool strict = false);
+				~guard(void);
+
+				guard(const guard&) = delete;
+				guard& operator= (const guard&) = delete;
+
+				size_t count(void) const;
+				size_t bytes(void) const;
+
+				bool is_ok(void) const;
+
+		};
+
+	protected:
+
+		static std::atomic<bool> s_enabled;
+
+		static std::atomic<size_t> s_count;
+		static std::atomic<size_t> s_bytes;
+		static std::atomic<int64_t> s_live;
+		static std::atomic<int64_t> s_peak;
+
+		static std::mutex s_lock;
+		static std::map<std::string, record> s_sites;
+
+		static thread_local const char* s_site;
+		static thread_local size_t s_tcount;
+		static thread_local size_t s_tbytes;
+
+	public:
+
+		static void allocated(size_t bytes);
+		static void released(size_t bytes);
+
+		static bool is_enabled(void);
+		static bool set_enabled(bool enabled);
+
+		static stats totals(void);
+		static std::map<std::string, record> sites(void);
+
+		static size_t thread_count(void);
+		static size_t thread_bytes(void);
+
+		static const char* current_site(void);
+
+		static bool print(std::ostream& stream);
+		static void reset(void);
+
+};
+
+#ifndef TRACKER_CPP
+#include "tracker.cpp"
+#endif
+
+#endif // TRACKER_HPP
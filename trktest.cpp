@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+#include <sstream>
+
+#include "matrix.hpp"
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	alloc_tracker::set_enabled(true);
+	alloc_tracker::reset();
+
+	const auto base = alloc_tracker::totals();
+
+	{
+		alloc_tracker::site site("setup");
+
+		matrix<double> a(10, 10, 1.0), b(10, 10, 2.0);
+		matrix<double> c = a;
+
+		const auto sum = alloc_tracker::totals();
+
+		if (sum.count != 3 || sum.bytes != 3 * 800) endtest(n, ok);
+		if (sum.live != base.live + 3 * 800 || sum.peak < sum.live) endtest(n, ok);
+
+		{
+			alloc_tracker::guard guard(0, "in-place");
+
+			for (int i = 0; i < 10; ++i) { c += a; c -= b; c *= 2.0; }
+
+			if (!guard.is_ok() || guard.count() != 0) endtest(n, ok);
+		}
+
+		{
+			alloc_tracker::guard guard(1, "temporaries");
+
+			for (int i = 0; i < 3; ++i) c = a + b;
+
+			if (guard.is_ok() || guard.count() != 3 || guard.bytes() != 3 * 800) endtest(n, ok);
+		}
+	}
+
+	const auto sites = alloc_tracker::sites();
+	const auto sum = alloc_tracker::totals();
+
+	if (!sites.count("setup") || sites.at("setup").count != 6) endtest(n, ok);
+	if (sum.live != base.live || sum.peak < base.live + 4 * 800) endtest(n, ok);
+
+	std::stringstream report;
+
+	if (!alloc_tracker::print(report) || report.str().find("setup") == std::string::npos) endtest(n, ok);
+
+	matrix<int> d(4, 4);
+	d.clear();
+
+	if (d.is_valid() || alloc_tracker::totals().live != base.live) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#define debugmsg std::cout << "Test " << __FILE__ << " failed at line " << __LINE__ << std::endl
+#define endtest(num, ok) { debugmsg; ++num; } else { ++num; ++ok; }
+
+#include <iostream>
+
+#include "matrix.hpp"
+
+template<typename data, typename layout>
+bool check(size_t rows, size_t cols)
+{
+	matrix<data, layout> a(rows, cols);
+
+	for (size_t i = 0; i < rows; ++i)
+		for (size_t j = 0; j < cols; ++j)
+			a(i, j) = data(i * 1000 + j);
+
+	const auto t = a.transpose();
+	auto b = a; b.transpose_inplace();
+	auto c = matrix<data, layout>(a).transpose();
+
+	if (t.rows() != cols || t.cols() != rows) return false;
+	if (b.rows() != cols || b.cols() != rows) return false;
+
+	for (size_t i = 0; i < rows; ++i)
+		for (size_t j = 0; j < cols; ++j)
+			if (t(j, i) != a(i, j) || b(j, i) != a(i, j) || c(j, i) != a(i, j))
+				return false;
+
+	return b.transpose_inplace() && b == a;
+}
+
+int main(int argc, char* args[])
+{
+	int n = 0, ok = 0;
+
+	const size_t shapes[][2] = {{ 1, 1 }, { 1, 70 }, { 70, 1 }, { 3, 3 }, { 64, 64 },
+						   { 97, 97 }, { 37, 53 }, { 128, 3 }, { 2, 200 }, { 130, 66 }};
+
+	for (const auto& s : shapes)
+	{
+		if (!check<double, row_major>(s[0], s[1])) endtest(n, ok);
+		if (!check<int, col_major>(s[0], s[1])) endtest(n, ok);
+		if (!check<float, tiled<4>>(s[0], s[1])) endtest(n, ok);
+	}
+
+	matrix<double> big(300, 300, 1.0);
+	big.set_ompmin(1);
+	big(7, 250) = 5.0;
+
+	const auto tb = big.transpose();
+	big.transpose_inplace();
+
+	if (tb(250, 7) != 5.0 || big(250, 7) != 5.0 || big != tb) endtest(n, ok);
+
+	matrix<double> empty;
+
+	if (empty.transpose_inplace() || empty.transpose().is_valid()) endtest(n, ok);
+
+	return !(n == ok);
+}
@@ -0,0 +1,288 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TUNING_CPP
+#define TUNING_CPP
+
+#ifndef TUNING_HPP
+#include "tuning.hpp"
+#endif
+
+inline cost_model::cost_model(void)
+{
+	m_cost[size_t(op::fill)] = 0.15;
+	m_cost[size_t(op::copy)] = 0.25;
+	m_cost[size_t(op::elementwise)] = 0.35;
+	m_cost[size_t(op::scalar)] = 0.25;
+	m_cost[size_t(op::reduce)] = 0.30;
+	m_cost[size_t(op::apply)] = 2.00;
+	m_cost[size_t(op::transpose)] = 1.00;
+	m_cost[size_t(op::submatrix)] = 0.50;
+	m_cost[size_t(op::gemm)] = 0.40;
+	m_cost[size_t(op::det)] = 2.00;
+}
+
+inline const char* cost_model::get_name(op o)
+{
+	static const char* names[s_count] =
+	{
+		"fill", "copy", "elementwise", "scalar", "reduce",
+		"apply", "transpose", "submatrix", "gemm", "det"
+	};
+
+	return o < op::count ? names[size_t(o)] : "";
+}
+
+inline double cost_model::measure(const std::function<void (void)>& f, size_t reps)
+{
+	using namespace std::chrono;
+
+	std::vector<double> times(reps);
+
+	f();
+
+	for (auto& t : times)
+	{
+		const auto start = steady_clock::now(); f();
+		const auto stop = steady_clock::now();
+
+		t = duration<double, std::nano>(stop - start).count();
+	}
+
+	std::nth_element(times.begin(), times.begin() + reps / 2, times.end());
+
+	return times[reps / 2];
+}
+
+inline size_t cost_model::threads(op o, size_t units, size_t esize) const
+{
+	if (o >= op::count || units == 0) return 1;
+
+	const size_t tnum = m_threads.load(std::memory_order_relaxed);
+	const size_t limit = tnum ? tnum : parallel::threads();
+	if (limit <= 1) return 1;
+
+	const double scale = double(esize) / double(sizeof(double));
+	const double cost = m_cost[size_t(o)].load(std::memory_order_relaxed);
+	const double minwork = m_minwork.load(std::memory_order_relaxed);
+	const double overhead = m_overhead.load(std::memory_order_relaxed);
+
+	const double work = double(units) * cost * scale;
+
+	if (work < minwork + overhead) return 1;
+
+	const double num = work / minwork;
+
+	return num >= double(limit) ? limit : std::max<size_t>(2, size_t(num));
+}
+
+inline double cost_model::get_cost(op o) const
+{
+	return o < op::count ? m_cost[size_t(o)].load() : 0.0;
+}
+
+inline bool cost_model::set_cost(op o, double ns)
+{
+	if (o >= op::count || !(ns > 0.0)) return false;
+
+	m_cost[size_t(o)] = ns;
+
+	return true;
+}
+
+inline double cost_model::get_overhead(void) const
+{
+	return m_overhead;
+}
+
+inline bool cost_model::set_overhead(double ns)
+{
+	if (!(ns >= 0.0)) return false;
+
+	m_overhead = ns;
+
+	return true;
+}
+
+inline double cost_model::get_minwork(void) const
+{
+	return m_minwork;
+}
+
+inline bool cost_model::set_minwork(double ns)
+{
+	if (!(ns > 0.0)) return false;
+
+	m_minwork = ns;
+
+	return true;
+}
+
+inline size_t cost_model::get_threads(void) const
+{
+	return m_threads;
+}
+
+inline bool cost_model::set_threads(size_t num)
+{
+	m_threads = num;
+
+	return true;
+}
+
+inline bool cost_model::calibrate(void)
+{
+	const size_t size = 1 << 16, side = 256, dim = 48;
+	const size_t tnum = parallel::threads();
+	const size_t reps = 15;
+
+	std::vector<double> a(size, 1.0), b(size, 2.0), c(size);
+	std::array<double, s_count> cost;
+	volatile double sink = 0.0;
+
+	const double overhead = tnum <= 1 ? 0.0 : measure([&] (void)
+	{
+		parallel::run(tnum, tnum, [&] (size_t, size_t) { sink = sink + 1.0; });
+	}, reps * 4);
+
+	const std::function<double (double)> fun = [] (double v) { return v * 3.0; };
+
+	cost[size_t(op::fill)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < size; ++i) c[i] = 3.0;
+	}, reps) / size;
+
+	cost[size_t(op::copy)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < size; ++i) c[i] = a[i];
+	}, reps) / size;
+
+	cost[size_t(op::elementwise)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < size; ++i) c[i] = a[i] + b[i];
+	}, reps) / size;
+
+	cost[size_t(op::scalar)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < size; ++i) c[i] = a[i] * 3.0;
+	}, reps) / size;
+
+	cost[size_t(op::reduce)] = measure([&] (void)
+	{
+		double s = 0.0; for (size_t i = 0; i < size; ++i) s += a[i]; sink = s;
+	}, reps) / size;
+
+	cost[size_t(op::apply)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < size; ++i) c[i] = fun(a[i]);
+	}, reps) / size;
+
+	cost[size_t(op::transpose)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < side; ++i)
+			for (size_t j = 0; j < side; ++j)
+				c[j * side + i] = a[i * side + j];
+	}, reps) / (side * side);
+
+	cost[size_t(op::submatrix)] = cost[size_t(op::copy)] * 2.0;
+
+	cost[size_t(op::gemm)] = measure([&] (void)
+	{
+		for (size_t i = 0; i < dim; ++i)
+			for (size_t k = 0; k < dim; ++k)
+			{
+				const double m = a[i * dim + k];
+				for (size_t j = 0; j < dim; ++j)
+					c[i * dim + j] += m * b[k * dim + j];
+			}
+	}, reps) / (dim * dim * dim);
+
+	cost[size_t(op::det)] = cost[size_t(op::gemm)] * 4.0;
+
+	for (size_t i = 0; i < s_count; ++i)
+		m_cost[i] = std::max(cost[i], 1e-3);
+
+	m_overhead = overhead;
+	m_minwork = std::max(overhead * 4.0, 2000.0);
+
+	return true;
+}
+
+inline bool cost_model::load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.good()) return false;
+
+	std::string name; double val;
+	bool ok = false;
+
+	while (file >> name >> val)
+	{
+		if (name == "overhead") ok = set_overhead(val) || ok;
+		else if (name == "minwork") ok = set_minwork(val) || ok;
+		else if (name == "threads") ok = set_threads(size_t(val)) || ok;
+		else for (size_t i = 0; i < s_count; ++i)
+			if (name == get_name(op(i))) ok = set_cost(op(i), val) || ok;
+	}
+
+	return ok;
+}
+
+inline bool cost_model::save(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.good()) return false;
+
+	file << "overhead " << get_overhead() << '\n'
+		<< "minwork " << get_minwork() << '\n'
+		<< "threads " << get_threads() << '\n';
+
+	for (size_t i = 0; i < s_count; ++i)
+		file << get_name(op(i)) << ' ' << m_cost[i] << '\n';
+
+	return !file.fail();
+}
+
+inline std::string cost_model::default_path(void)
+{
+	if (const char* env = std::getenv("MATRIX_TUNING")) return env;
+	else if (const char* home = std::getenv("HOME"))
+		return std::string(home) + "/.simple-matrix-tuning";
+	else return ".simple-matrix-tuning";
+}
+
+inline cost_model& cost_model::global(void)
+{
+	static cost_model model;
+	static std::once_flag flag;
+
+	std::call_once(flag, [] (void)
+	{
+		const std::string path = default_path();
+
+		if (model.load(path)) return;
+		else if (std::getenv("MATRIX_CALIBRATE") &&
+			    model.calibrate()) model.save(path);
+	});
+
+	return model;
+}
+
+#endif
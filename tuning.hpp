@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                         *
+ *  Simple matrix implementation for simulation purposes                   *
+ *  Copyright (C) 2022  Łukasz "Kuszki" Dróżdż  lukasz.kuszki@gmail.com    *
+ *                                                                         *
+ *  This program is free software: you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the  Free Software Foundation, either  version 3 of the  License, or   *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This  program  is  distributed  in the hope  that it will be useful,   *
+ *  but WITHOUT ANY  WARRANTY;  without  even  the  implied  warranty of   *
+ *  MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the   *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *  You should have  received a copy  of the  GNU General Public License   *
+ *  along with this program. If not, see http://www.gnu.org/licenses/.     *
+ *                                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TUNING_HPP
+#define TUNING_HPP
+
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <mutex>
+
+#include <cstddef>
+#include <cstdlib>
+
+#include "parallel.hpp"
+
+class cost_model
+{
+
+	public:
+
+		enum class op
+		{
+			fill,
+			copy,
+			elementwise,
+			scalar,
+			reduce,
+			apply,
+			transpose,
+			submatrix,
+			gemm,
+			det,
+			count
+		};
+
+	protected:
+
+		static constexpr size_t s_count = size_t(op::count);
+
+		std::array<std::atomic<double>, s_count> m_cost;
+
+		std::atomic<double> m_overhead = 4000.0;
+		std::atomic<double> m_minwork = 20000.0;
+
+		std::atomic<size_t> m_threads = 0;
+
+		static const char* get_name(op o);
+
+		static double measure(const std::function<void (void)>& f, size_t reps);
+
+	public:
+
+		cost_model(void);
+
+		cost_model(const cost_model&) = delete;
+		cost_model& operator= (const cost_model&) = delete;
+
+		size_t threads(op o, size_t units, size_t esize = sizeof(double)) const;
+
+		double get_cost(op o) const;
+		bool set_cost(op o, double ns);
+
+		double get_overhead(void) const;
+		bool set_overhead(double ns);
+
+		double get_minwork(void) const;
+		bool set_minwork(double ns);
+
+		size_t get_threads(void) const;
+		bool set_threads(size_t num);
+
+		bool calibrate(void);
+
+		bool load(const std::string& path);
+		bool save(const std::string& path) const;
+
+		static std::string default_path(void);
+		static cost_model& global(void);
+
+};
+
+#ifndef TUNING_CPP
+#include "tuning.cpp"
+#endif
+
+#endif // TUNING_HPP
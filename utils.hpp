@@ -27,6 +27,8 @@
 #include <cmath>
 
 #include "helper.hpp"
+#include "cache.hpp"
+#include "loader.hpp"
 
 std::vector<std::pair<size_t, size_t>> get_fwt_levels(size_t count, size_t dec);
 